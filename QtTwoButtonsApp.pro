@@ -1,19 +1,83 @@
-QT += core widgets uitools
+QT += core widgets uitools network
 
 CONFIG += c++17
 
 TARGET = QtTwoButtonsApp
 TEMPLATE = app
 
-SOURCES += main.cpp
+SOURCES += main.cpp \
+    mainwindow.cpp \
+    hotreloader.cpp \
+    singleinstance.cpp \
+    fontloader.cpp \
+    snapshotrunner.cpp \
+    imagediff.cpp \
+    metrics.cpp \
+    metricsserver.cpp \
+    memoryreport.cpp \
+    eventstream.cpp \
+    eventrecorder.cpp \
+    eventreplayer.cpp \
+    startuptracer.cpp \
+    logcategories.cpp \
+    logsink.cpp \
+    stallwatchdog.cpp \
+    latencyhistogram.cpp \
+    latencymonitor.cpp \
+    stylesheetcache.cpp \
+    iosstyle.cpp \
+    rendercache.cpp \
+    dialogservice.cpp \
+    actionregistry.cpp \
+    actionexecutor.cpp \
+    actionlistmodel.cpp \
+    actiondelegate.cpp
 
-# Copy styles.qss to output directory
+HEADERS += mainwindow.h \
+    hotreloader.h \
+    singleinstance.h \
+    fontloader.h \
+    snapshotrunner.h \
+    imagediff.h \
+    metrics.h \
+    metricsserver.h \
+    memoryreport.h \
+    eventstream.h \
+    eventrecorder.h \
+    eventreplayer.h \
+    startuptracer.h \
+    logcategories.h \
+    logsink.h \
+    stallwatchdog.h \
+    latencyhistogram.h \
+    latencymonitor.h \
+    stylesheetcache.h \
+    iosstyle.h \
+    rendercache.h \
+    dialogservice.h \
+    actionregistry.h \
+    actionexecutor.h \
+    actionlistmodel.h \
+    actiondelegate.h
+
+FORMS += mainwindow.ui \
+    primarytab.ui \
+    secondarytab.ui \
+    destructivetab.ui
+
+RESOURCES += resources.qrc \
+    fonts.qrc
+
+# Debug log output (qCDebug) is compiled out of release builds
+CONFIG(release, debug|release): DEFINES += QT_NO_DEBUG_OUTPUT
+
+# Copy styles.qss and mainwindow.ui to output directory for the --dynamic-ui developer override
 styles.files = styles.qss
 styles.path = $$OUT_PWD
 INSTALLS += styles
 
 # Copy UI file to output directory
-ui.files = mainwindow.ui
+ui.files = mainwindow.ui primarytab.ui secondarytab.ui destructivetab.ui
 ui.path = $$OUT_PWD
 INSTALLS += ui
 
@@ -0,0 +1,92 @@
+#include "actiondelegate.h"
+
+#include <QAbstractItemView>
+#include <QEvent>
+#include <QFontMetrics>
+#include <QPainter>
+
+#include "actionlistmodel.h"
+#include "iosstyle.h"
+
+namespace {
+
+// Values mirror the QPushButton rules in styles.qss
+const int ButtonMargin = 8;
+const int ButtonHeight = 50;
+const int ButtonPadding = 24;
+const qreal ButtonRadius = 12;
+const int FontPixelSize = 17;
+
+} // namespace
+
+ActionDelegate::ActionDelegate(QObject *parent) : QStyledItemDelegate(parent)
+{
+}
+
+void ActionDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
+                           const QModelIndex &index) const
+{
+    const IosStyle::Variant variant =
+        static_cast<IosStyle::Variant>(index.data(ActionListModel::VariantRole).toInt());
+
+    const bool running = index.data(ActionListModel::RunningRole).toBool();
+    QStyle::State state = option.state & QStyle::State_MouseOver;
+    if (!running) {
+        state |= QStyle::State_Enabled;
+    }
+    if (index == m_pressedIndex) {
+        state |= QStyle::State_Sunken;
+    }
+
+    const QRectF buttonRect = QRectF(option.rect).adjusted(ButtonMargin, ButtonMargin,
+                                                           -ButtonMargin, -ButtonMargin);
+    IosStyle::drawButtonShape(painter, buttonRect, variant, state, ButtonRadius);
+
+    QFont font = option.font;
+    font.setPixelSize(FontPixelSize);
+    font.setWeight(QFont::DemiBold);
+
+    QColor text = IosStyle::colors(variant).text;
+    if (!(state & QStyle::State_Enabled)) {
+        text.setAlphaF(0.6);
+    }
+
+    painter->save();
+    painter->setFont(font);
+    painter->setPen(text);
+    // The label is elided first, so the progress always stays visible
+    const QString progress =
+        running ? QString(" (%1%)").arg(index.data(ActionListModel::ProgressRole).toInt()) : QString();
+    const QFontMetrics metrics(font);
+    painter->drawText(buttonRect, Qt::AlignCenter,
+                      metrics.elidedText(index.data().toString(), Qt::ElideRight,
+                                         buttonRect.toRect().width() - 2 * ButtonPadding
+                                             - metrics.horizontalAdvance(progress))
+                          + progress);
+    painter->restore();
+}
+
+QSize ActionDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    Q_UNUSED(index);
+    return QSize(option.rect.width(), ButtonHeight + 2 * ButtonMargin);
+}
+
+bool ActionDelegate::editorEvent(QEvent *event, QAbstractItemModel *model, const QStyleOptionViewItem &option,
+                                 const QModelIndex &index)
+{
+    QAbstractItemView *view = qobject_cast<QAbstractItemView*>(const_cast<QWidget*>(option.widget));
+    const QModelIndex previous = m_pressedIndex;
+
+    if (event->type() == QEvent::MouseButtonPress) {
+        m_pressedIndex = index;
+    } else if (event->type() == QEvent::MouseButtonRelease) {
+        m_pressedIndex = QPersistentModelIndex();
+    }
+
+    if (view && previous != QModelIndex(m_pressedIndex)) {
+        view->update(previous);
+        view->update(m_pressedIndex);
+    }
+    return QStyledItemDelegate::editorEvent(event, model, option, index);
+}
@@ -0,0 +1,30 @@
+#ifndef ACTIONDELEGATE_H
+#define ACTIONDELEGATE_H
+
+#include <QPersistentModelIndex>
+#include <QStyledItemDelegate>
+
+// Paints each row of an ActionListModel as an iOS button of its variant,
+// using the same shapes and colors as IosStyle. Rows have a fixed height so
+// the view can lay out any number of them without measuring each one.
+class ActionDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    explicit ActionDelegate(QObject *parent = nullptr);
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option,
+               const QModelIndex &index) const override;
+    QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+
+protected:
+    // Tracks the pressed row; item views do not report State_Sunken
+    bool editorEvent(QEvent *event, QAbstractItemModel *model, const QStyleOptionViewItem &option,
+                     const QModelIndex &index) override;
+
+private:
+    QPersistentModelIndex m_pressedIndex;
+};
+
+#endif // ACTIONDELEGATE_H
@@ -0,0 +1,116 @@
+#include "actionexecutor.h"
+
+#include <QMetaObject>
+#include <QRunnable>
+
+#include <utility>
+
+namespace {
+
+class ActionTask : public QRunnable
+{
+public:
+    explicit ActionTask(std::function<void()> body) : m_body(std::move(body)) {}
+
+    void run() override
+    {
+        m_body();
+    }
+
+private:
+    std::function<void()> m_body;
+};
+
+} // namespace
+
+ActionContext::ActionContext(ActionExecutor *executor, int runId, const QString &actionId,
+                             std::shared_ptr<std::atomic<bool>> cancelled)
+    : m_executor(executor)
+    , m_runId(runId)
+    , m_actionId(actionId)
+    , m_cancelled(std::move(cancelled))
+{
+}
+
+void ActionContext::reportProgress(int percent)
+{
+    ActionExecutor *executor = m_executor;
+    const int runId = m_runId;
+    const QString actionId = m_actionId;
+    QMetaObject::invokeMethod(executor, [executor, runId, actionId, percent]() {
+        executor->deliverProgress(runId, actionId, percent);
+    }, Qt::QueuedConnection);
+}
+
+ActionExecutor::ActionExecutor(QObject *parent) : QObject(parent)
+{
+}
+
+ActionExecutor::~ActionExecutor()
+{
+    // Results still queued for this object are dropped with it
+    cancelAll();
+    m_pool.waitForDone();
+}
+
+int ActionExecutor::run(const QString &actionId, const ActionHandler &handler, const QVariantMap &params)
+{
+    const int runId = m_nextRunId++;
+    auto cancelled = std::make_shared<std::atomic<bool>>(false);
+    m_running.insert(runId, cancelled);
+
+    ActionExecutor *executor = this;
+    m_pool.start(new ActionTask([executor, runId, actionId, handler, params, cancelled]() {
+        ActionContext context(executor, runId, actionId, cancelled);
+
+        QVariant result;
+        if (!handler) {
+            context.setError(QStringLiteral("Unknown handler for action %1").arg(actionId));
+        } else if (!context.isCancelled()) {
+            result = handler(context, params);
+        }
+
+        Status status = Completed;
+        if (context.isCancelled()) {
+            status = Cancelled;
+        } else if (!context.error().isEmpty()) {
+            status = Failed;
+        }
+
+        const QString error = context.error();
+        QMetaObject::invokeMethod(executor, [executor, runId, actionId, status, result, error]() {
+            executor->deliverResult(runId, actionId, status, result, error);
+        }, Qt::QueuedConnection);
+    }));
+
+    return runId;
+}
+
+void ActionExecutor::cancel(int runId)
+{
+    auto it = m_running.constFind(runId);
+    if (it != m_running.constEnd()) {
+        it.value()->store(true, std::memory_order_relaxed);
+    }
+}
+
+void ActionExecutor::cancelAll()
+{
+    for (const auto &cancelled : std::as_const(m_running)) {
+        cancelled->store(true, std::memory_order_relaxed);
+    }
+}
+
+void ActionExecutor::deliverProgress(int runId, const QString &actionId, int percent)
+{
+    if (m_running.contains(runId)) {
+        emit progressChanged(runId, actionId, percent);
+    }
+}
+
+void ActionExecutor::deliverResult(int runId, const QString &actionId, Status status,
+                                   const QVariant &result, const QString &error)
+{
+    m_running.remove(runId);
+    emit finished(runId, actionId, status, result, error);
+}
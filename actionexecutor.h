@@ -0,0 +1,85 @@
+#ifndef ACTIONEXECUTOR_H
+#define ACTIONEXECUTOR_H
+
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+#include <QVariant>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+class ActionExecutor;
+
+// Passed to a handler on its worker thread
+class ActionContext
+{
+public:
+    ActionContext(ActionExecutor *executor, int runId, const QString &actionId,
+                  std::shared_ptr<std::atomic<bool>> cancelled);
+
+    const QString &actionId() const { return m_actionId; }
+    bool isCancelled() const { return m_cancelled->load(std::memory_order_relaxed); }
+
+    // Delivered to the UI thread through a queued call
+    void reportProgress(int percent);
+
+    void setError(const QString &message) { m_error = message; }
+    const QString &error() const { return m_error; }
+
+private:
+    ActionExecutor *m_executor;
+    int m_runId;
+    QString m_actionId;
+    std::shared_ptr<std::atomic<bool>> m_cancelled;
+    QString m_error;
+};
+
+using ActionHandler = std::function<QVariant(ActionContext &context, const QVariantMap &params)>;
+
+// Runs action handlers on a thread pool. Progress and results come back on
+// the thread that owns the executor (the UI thread) as queued calls, so
+// slots connected to its signals can touch widgets directly.
+class ActionExecutor : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Status {
+        Completed,
+        Cancelled,
+        Failed
+    };
+    Q_ENUM(Status)
+
+    explicit ActionExecutor(QObject *parent = nullptr);
+    ~ActionExecutor() override;
+
+    // Returns a run id for cancel() and the signals below. An empty handler
+    // (an unknown handler name) finishes as Failed.
+    int run(const QString &actionId, const ActionHandler &handler, const QVariantMap &params);
+    void cancel(int runId);
+    void cancelAll();
+
+    int activeCount() const { return m_running.size(); }
+
+signals:
+    void progressChanged(int runId, const QString &actionId, int percent);
+    void finished(int runId, const QString &actionId, ActionExecutor::Status status,
+                  const QVariant &result, const QString &error);
+
+private:
+    friend class ActionContext;
+
+    void deliverProgress(int runId, const QString &actionId, int percent);
+    void deliverResult(int runId, const QString &actionId, Status status,
+                       const QVariant &result, const QString &error);
+
+    QThreadPool m_pool;
+    QHash<int, std::shared_ptr<std::atomic<bool>>> m_running;
+    int m_nextRunId = 1;
+};
+
+#endif // ACTIONEXECUTOR_H
@@ -0,0 +1,119 @@
+#include "actionlistmodel.h"
+
+ActionListModel::ActionListModel(QObject *parent) : QAbstractListModel(parent)
+{
+}
+
+void ActionListModel::setActions(const QList<ActionDefinition> &actions)
+{
+    beginResetModel();
+    m_entries.clear();
+    m_rowForId.clear();
+    m_entries.reserve(actions.size());
+    m_rowForId.reserve(actions.size());
+    for (const ActionDefinition &action : actions) {
+        Entry entry;
+        entry.id = action.id;
+        entry.label = action.label.isEmpty() ? action.id : action.label;
+        entry.searchKey = entry.label.toLower();
+        entry.variant = IosStyle::variantFromName(action.variant);
+        m_rowForId.insert(entry.id, m_entries.size());
+        m_entries.append(entry);
+    }
+    endResetModel();
+}
+
+void ActionListModel::setRunning(const QString &id, bool running)
+{
+    const int row = m_rowForId.value(id, -1);
+    if (row < 0 || m_entries.at(row).running == running) {
+        return;
+    }
+    m_entries[row].running = running;
+    m_entries[row].progress = 0;
+    const QModelIndex changed = index(row);
+    emit dataChanged(changed, changed, { RunningRole, ProgressRole });
+}
+
+void ActionListModel::setProgress(const QString &id, int percent)
+{
+    const int row = m_rowForId.value(id, -1);
+    if (row < 0 || !m_entries.at(row).running || m_entries.at(row).progress == percent) {
+        return;
+    }
+    m_entries[row].progress = percent;
+    const QModelIndex changed = index(row);
+    emit dataChanged(changed, changed, { ProgressRole });
+}
+
+int ActionListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_entries.size();
+}
+
+QVariant ActionListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_entries.size()) {
+        return QVariant();
+    }
+
+    const Entry &entry = m_entries.at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+    case Qt::AccessibleTextRole:
+        return entry.label;
+    case IdRole:
+        return entry.id;
+    case VariantRole:
+        return entry.variant;
+    case RunningRole:
+        return entry.running;
+    case ProgressRole:
+        return entry.progress;
+    case SearchKeyRole:
+        return entry.searchKey;
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> ActionListModel::roleNames() const
+{
+    QHash<int, QByteArray> names = QAbstractListModel::roleNames();
+    names.insert(IdRole, "actionId");
+    names.insert(VariantRole, "variant");
+    names.insert(RunningRole, "running");
+    names.insert(ProgressRole, "progress");
+    return names;
+}
+
+ActionFilterModel::ActionFilterModel(QObject *parent) : QSortFilterProxyModel(parent)
+{
+}
+
+void ActionFilterModel::setVariant(IosStyle::Variant variant)
+{
+    m_variant = variant;
+    m_filterVariant = true;
+    invalidateFilter();
+}
+
+void ActionFilterModel::setFilterText(const QString &text)
+{
+    const QString filterText = text.trimmed().toLower();
+    if (filterText == m_filterText) {
+        return;
+    }
+    m_filterText = filterText;
+    invalidateFilter();
+}
+
+bool ActionFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    const QModelIndex index = sourceModel()->index(sourceRow, 0, sourceParent);
+    if (m_filterVariant && index.data(ActionListModel::VariantRole).toInt() != m_variant) {
+        return false;
+    }
+    return m_filterText.isEmpty()
+           || index.data(ActionListModel::SearchKeyRole).toString().contains(m_filterText);
+}
@@ -0,0 +1,81 @@
+#ifndef ACTIONLISTMODEL_H
+#define ACTIONLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QList>
+#include <QSortFilterProxyModel>
+#include <QString>
+#include <QVector>
+
+#include "actionregistry.h"
+#include "iosstyle.h"
+
+// Flat list of actions for the model/view mode. Only the fields the view
+// needs are kept per row, so thousands of actions cost a few strings each
+// instead of a styled QPushButton each.
+class ActionListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Role {
+        IdRole = Qt::UserRole + 1,
+        VariantRole,
+        RunningRole,
+        // 0-100 while running
+        ProgressRole,
+        // Lower-cased label, precomputed so filtering does not fold case per row
+        SearchKeyRole
+    };
+
+    explicit ActionListModel(QObject *parent = nullptr);
+
+    void setActions(const QList<ActionDefinition> &actions);
+
+    // Running actions are painted dimmed with their progress; a click on one
+    // cancels it
+    void setRunning(const QString &id, bool running);
+    void setProgress(const QString &id, int percent);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+private:
+    struct Entry
+    {
+        QString id;
+        QString label;
+        QString searchKey;
+        IosStyle::Variant variant = IosStyle::Primary;
+        bool running = false;
+        int progress = 0;
+    };
+
+    QVector<Entry> m_entries;
+    QHash<QString, int> m_rowForId;
+};
+
+// Restricts an ActionListModel to one variant and to labels containing the
+// filter text.
+class ActionFilterModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit ActionFilterModel(QObject *parent = nullptr);
+
+    void setVariant(IosStyle::Variant variant);
+    void setFilterText(const QString &text);
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+private:
+    IosStyle::Variant m_variant = IosStyle::Primary;
+    bool m_filterVariant = false;
+    QString m_filterText;
+};
+
+#endif // ACTIONLISTMODEL_H
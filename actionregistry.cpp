@@ -0,0 +1,164 @@
+#include "actionregistry.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+
+#include "logcategories.h"
+
+namespace {
+
+QMessageBox::Icon iconFromName(const QString &name)
+{
+    if (name == QLatin1String("warning")) {
+        return QMessageBox::Warning;
+    }
+    if (name == QLatin1String("critical")) {
+        return QMessageBox::Critical;
+    }
+    if (name == QLatin1String("question")) {
+        return QMessageBox::Question;
+    }
+    return QMessageBox::Information;
+}
+
+QMessageBox::StandardButtons buttonsFromNames(const QJsonArray &names, QMessageBox::StandardButtons fallback)
+{
+    QMessageBox::StandardButtons buttons;
+    bool any = false;
+    for (const QJsonValue &value : names) {
+        const QString name = value.toString();
+        if (name == QLatin1String("ok")) {
+            buttons |= QMessageBox::Ok;
+        } else if (name == QLatin1String("yes")) {
+            buttons |= QMessageBox::Yes;
+        } else if (name == QLatin1String("no")) {
+            buttons |= QMessageBox::No;
+        } else if (name == QLatin1String("cancel")) {
+            buttons |= QMessageBox::Cancel;
+        } else {
+            qCWarning(lcActions) << "Unknown dialog button in actions.json:" << name;
+            continue;
+        }
+        any = true;
+    }
+    return any ? buttons : fallback;
+}
+
+DialogRequest dialogFromJson(const QJsonObject &object, QMessageBox::StandardButtons defaultButtons)
+{
+    DialogRequest request;
+    request.objectName = object.value("objectName").toString();
+    request.title = object.value("title").toString();
+    request.text = object.value("text").toString();
+    request.informativeText = object.value("informativeText").toString();
+    request.icon = iconFromName(object.value("icon").toString());
+    request.buttons = buttonsFromNames(object.value("buttons").toArray(), defaultButtons);
+    return request;
+}
+
+// Buttons are named after their variant (secondaryButton2, destructiveButton, ...)
+QString variantFromId(const QString &id)
+{
+    if (id.startsWith(QLatin1String("secondary"))) {
+        return QStringLiteral("secondary");
+    }
+    if (id.startsWith(QLatin1String("destructive"))) {
+        return QStringLiteral("destructive");
+    }
+    return QStringLiteral("primary");
+}
+
+} // namespace
+
+ActionRegistry::ActionRegistry()
+{
+    // Finishes at once; used by actions that only acknowledge the click
+    registerHandler("acknowledge", [](ActionContext &context, const QVariantMap &) {
+        context.reportProgress(100);
+        return QVariant();
+    });
+
+    // Sleeps for params.durationMs in steps, reporting progress and honouring
+    // cancellation; for trying out long-running actions
+    registerHandler("delay", [](ActionContext &context, const QVariantMap &params) {
+        const int durationMs = params.value("durationMs", 1000).toInt();
+        const int steps = 20;
+        for (int step = 1; step <= steps && !context.isCancelled(); ++step) {
+            QThread::msleep(durationMs / steps);
+            context.reportProgress(step * 100 / steps);
+        }
+        return QVariant();
+    });
+}
+
+bool ActionRegistry::load(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly)) {
+        qCWarning(lcActions) << "Could not open action table:" << path << "-" << file.errorString();
+        return false;
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (document.isNull()) {
+        qCWarning(lcActions) << "Could not parse action table:" << path << "-" << parseError.errorString();
+        return false;
+    }
+
+    m_actions.clear();
+    m_order.clear();
+
+    const QJsonArray actions = document.object().value("actions").toArray();
+    for (const QJsonValue &value : actions) {
+        const QJsonObject object = value.toObject();
+
+        ActionDefinition action;
+        action.id = object.value("button").toString();
+        action.label = object.value("label").toString(action.id);
+        action.variant = object.value("variant").toString(variantFromId(action.id));
+        action.handler = object.value("handler").toString("acknowledge");
+        action.params = object.value("params").toObject().toVariantMap();
+        action.hasConfirmation = object.contains("confirmation");
+        if (action.hasConfirmation) {
+            action.confirmation = dialogFromJson(object.value("confirmation").toObject(),
+                                                 QMessageBox::Yes | QMessageBox::No);
+        }
+        action.completion = dialogFromJson(object.value("completion").toObject(), QMessageBox::Ok);
+
+        if (action.id.isEmpty()) {
+            qCWarning(lcActions) << "Skipping action without a button name in" << path;
+            continue;
+        }
+        if (!m_handlers.contains(action.handler)) {
+            qCWarning(lcActions) << "Action" << action.id << "uses unknown handler:" << action.handler
+                                 << "- it will fail when triggered";
+        }
+        if (!m_actions.contains(action.id)) {
+            m_order.append(action.id);
+        }
+        m_actions.insert(action.id, action);
+    }
+
+    qCDebug(lcActions) << "Loaded" << m_actions.size() << "actions from:" << path;
+    return true;
+}
+
+QList<ActionDefinition> ActionRegistry::actions() const
+{
+    QList<ActionDefinition> actions;
+    actions.reserve(m_order.size());
+    for (const QString &id : m_order) {
+        actions.append(m_actions.value(id));
+    }
+    return actions;
+}
+
+void ActionRegistry::registerHandler(const QString &name, const ActionHandler &handler)
+{
+    m_handlers.insert(name, handler);
+}
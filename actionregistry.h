@@ -0,0 +1,53 @@
+#ifndef ACTIONREGISTRY_H
+#define ACTIONREGISTRY_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QVariantMap>
+
+#include "actionexecutor.h"
+#include "dialogservice.h"
+
+struct ActionDefinition
+{
+    // Object name of the button that triggers the action
+    QString id;
+    // Text shown for the action in the list view
+    QString label;
+    // "primary", "secondary" or "destructive"
+    QString variant;
+    QString handler;
+    QVariantMap params;
+    // Asked before running; the action only runs on Yes
+    bool hasConfirmation = false;
+    DialogRequest confirmation;
+    // Shown once the handler has completed
+    DialogRequest completion;
+};
+
+// Maps button object names to actions loaded from actions.json, and handler
+// names to the functions that implement them.
+class ActionRegistry
+{
+public:
+    ActionRegistry();
+
+    bool load(const QString &path);
+
+    void registerHandler(const QString &name, const ActionHandler &handler);
+    ActionHandler handler(const QString &name) const { return m_handlers.value(name); }
+
+    bool contains(const QString &id) const { return m_actions.contains(id); }
+    ActionDefinition action(const QString &id) const { return m_actions.value(id); }
+    const QList<QString> &ids() const { return m_order; }
+    // In table order
+    QList<ActionDefinition> actions() const;
+
+private:
+    QHash<QString, ActionDefinition> m_actions;
+    QList<QString> m_order;
+    QHash<QString, ActionHandler> m_handlers;
+};
+
+#endif // ACTIONREGISTRY_H
@@ -0,0 +1,162 @@
+// Checks ImageDiff::compare, whose rows run through SSE2 or NEON four pixels
+// at a time, against a plain per-channel loop: random images with widths that
+// leave a scalar tail, channel deltas right at and just over the tolerance,
+// alpha-only changes and the tolerance extremes.
+
+#include <QImage>
+#include <QRandomGenerator>
+#include <QtTest>
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "imagediff.h"
+
+namespace {
+
+ImageDiffResult scalarCompare(const QImage &a, const QImage &b, int tolerance)
+{
+    ImageDiffResult result;
+    for (int y = 0; y < a.height(); ++y) {
+        const QRgb *lineA = reinterpret_cast<const QRgb *>(a.constScanLine(y));
+        const QRgb *lineB = reinterpret_cast<const QRgb *>(b.constScanLine(y));
+        for (int x = 0; x < a.width(); ++x) {
+            const int deltas[] = { std::abs(qRed(lineA[x]) - qRed(lineB[x])),
+                                   std::abs(qGreen(lineA[x]) - qGreen(lineB[x])),
+                                   std::abs(qBlue(lineA[x]) - qBlue(lineB[x])),
+                                   std::abs(qAlpha(lineA[x]) - qAlpha(lineB[x])) };
+            const int pixelMax = *std::max_element(deltas, deltas + 4);
+            result.maxDelta = std::max(result.maxDelta, pixelMax);
+            result.differingPixels += pixelMax > tolerance ? 1 : 0;
+        }
+    }
+    return result;
+}
+
+// Moves channel by delta in whichever direction stays within 0-255, or as
+// far as it goes when neither does
+int shifted(int channel, int delta)
+{
+    if (channel + delta <= 255) {
+        return channel + delta;
+    }
+    return channel - delta >= 0 ? channel - delta : (channel < 128 ? 255 : 0);
+}
+
+QImage randomImage(QRandomGenerator &random, int width, int height)
+{
+    QImage image(width, height, QImage::Format_ARGB32);
+    for (int y = 0; y < height; ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = 0; x < width; ++x) {
+            line[x] = random.generate();
+        }
+    }
+    return image;
+}
+
+// A copy of image with about a third of the pixels changed: per channel by
+// nothing, exactly the tolerance, one more, or anything; some in alpha only
+QImage perturbed(QRandomGenerator &random, const QImage &image, int tolerance)
+{
+    QImage copy = image.copy();
+    for (int y = 0; y < copy.height(); ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(copy.scanLine(y));
+        for (int x = 0; x < copy.width(); ++x) {
+            switch (random.bounded(6)) {
+            case 0: {
+                int channels[] = { qRed(line[x]), qGreen(line[x]), qBlue(line[x]), qAlpha(line[x]) };
+                for (int &channel : channels) {
+                    const int deltas[] = { 0, tolerance, std::min(tolerance + 1, 255), int(random.bounded(256)) };
+                    channel = shifted(channel, deltas[random.bounded(4)]);
+                }
+                line[x] = qRgba(channels[0], channels[1], channels[2], channels[3]);
+                break;
+            }
+            case 1:
+                line[x] = qRgba(qRed(line[x]), qGreen(line[x]), qBlue(line[x]),
+                                shifted(qAlpha(line[x]), std::min(tolerance + int(random.bounded(2)), 255)));
+                break;
+            default:
+                break;
+            }
+        }
+    }
+    return copy;
+}
+
+} // namespace
+
+class ImageDiffTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void matchesScalar_data();
+    void matchesScalar();
+    void alphaOnlyInTail();
+    void sizeMismatch();
+};
+
+void ImageDiffTest::matchesScalar_data()
+{
+    QTest::addColumn<int>("width");
+    QTest::addColumn<int>("height");
+    QTest::addColumn<int>("tolerance");
+
+    const int widths[] = { 1, 3, 5, 7, 13, 63, 97, 130 };
+    const int tolerances[] = { 0, 1, 2, 127, 254, 255 };
+    for (int width : widths) {
+        for (int tolerance : tolerances) {
+            QTest::addRow("%dpx tolerance %d", width, tolerance) << width << 9 << tolerance;
+        }
+    }
+}
+
+void ImageDiffTest::matchesScalar()
+{
+    QFETCH(int, width);
+    QFETCH(int, height);
+    QFETCH(int, tolerance);
+
+    // Seeded per row, so a failure reproduces
+    QRandomGenerator random(quint32(width * 1000 + tolerance));
+    for (int round = 0; round < 20; ++round) {
+        const QImage actual = randomImage(random, width, height);
+        const QImage expected = perturbed(random, actual, tolerance);
+
+        const ImageDiffResult reference = scalarCompare(actual, expected, tolerance);
+        const ImageDiffResult result = ImageDiff::compare(actual, expected, tolerance);
+        QVERIFY(result.sizeMatches);
+        QCOMPARE(result.differingPixels, reference.differingPixels);
+        QCOMPARE(result.maxDelta, reference.maxDelta);
+    }
+}
+
+void ImageDiffTest::alphaOnlyInTail()
+{
+    // 7 pixels: one SIMD block of four and a scalar tail of three
+    QImage actual(7, 1, QImage::Format_ARGB32);
+    actual.fill(qRgba(10, 20, 30, 200));
+    QImage expected = actual.copy();
+    expected.setPixel(1, 0, qRgba(10, 20, 30, 203));
+    expected.setPixel(6, 0, qRgba(10, 20, 30, 190));
+
+    ImageDiffResult result = ImageDiff::compare(actual, expected, 3);
+    QCOMPARE(result.differingPixels, qint64(1));
+    QCOMPARE(result.maxDelta, 10);
+
+    result = ImageDiff::compare(actual, expected, 0);
+    QCOMPARE(result.differingPixels, qint64(2));
+}
+
+void ImageDiffTest::sizeMismatch()
+{
+    const QImage actual(8, 8, QImage::Format_ARGB32);
+    const QImage expected(8, 9, QImage::Format_ARGB32);
+    QVERIFY(!ImageDiff::compare(actual, expected, 0).sizeMatches);
+}
+
+QTEST_APPLESS_MAIN(ImageDiffTest)
+
+#include "imagedifftest.moc"
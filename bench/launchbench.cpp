@@ -0,0 +1,130 @@
+// Compares a cold launch of QtTwoButtonsApp in single-instance mode (new
+// process, full QApplication and UI setup, until it accepts connections)
+// with a warm launch (a second process that hands its arguments to the
+// running instance and exits).
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QProcess>
+#include <QTextStream>
+#include <QThread>
+#include <QVector>
+
+#include <algorithm>
+
+#include "singleinstance.h"
+
+namespace {
+
+const int ColdRuns = 5;
+const int WarmRuns = 20;
+const int ReadyTimeoutMs = 10000;
+
+struct Summary
+{
+    double minMs = 0;
+    double medianMs = 0;
+    double maxMs = 0;
+};
+
+Summary summarize(QVector<double> samples)
+{
+    Summary summary;
+    if (samples.isEmpty()) {
+        return summary;
+    }
+    std::sort(samples.begin(), samples.end());
+    summary.minMs = samples.first();
+    summary.medianMs = samples.at(samples.size() / 2);
+    summary.maxMs = samples.last();
+    return summary;
+}
+
+QProcessEnvironment childEnvironment()
+{
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    if (!environment.contains("QT_QPA_PLATFORM")) {
+        environment.insert("QT_QPA_PLATFORM", "offscreen");
+    }
+    // Keep the stall report of benchmark runs out of the user's data directory
+    environment.insert("QTTWOBUTTONS_STALL_MS", "0");
+    return environment;
+}
+
+// Starts the first instance and returns the time until it accepts a forwarded launch
+double coldLaunch(QProcess &process, const QString &program)
+{
+    QElapsedTimer timer;
+    timer.start();
+    process.setProcessEnvironment(childEnvironment());
+    process.start(program, { "--single-instance" });
+    while (timer.elapsed() < ReadyTimeoutMs) {
+        if (SingleInstance::forward({ program }, 100)) {
+            return timer.nsecsElapsed() / 1e6;
+        }
+        QThread::msleep(1);
+    }
+    return -1;
+}
+
+double warmLaunch(const QString &program)
+{
+    QProcess process;
+    process.setProcessEnvironment(childEnvironment());
+    QElapsedTimer timer;
+    timer.start();
+    process.start(program, { "--single-instance", "--tab=secondary" });
+    process.waitForFinished(ReadyTimeoutMs);
+    return timer.nsecsElapsed() / 1e6;
+}
+
+void stopInstance(QProcess &process)
+{
+    SingleInstance::forward({ "--quit" });
+    if (!process.waitForFinished(ReadyTimeoutMs)) {
+        process.kill();
+        process.waitForFinished();
+    }
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    const QString program = QDir(QCoreApplication::applicationDirPath()).filePath("QtTwoButtonsApp");
+    if (SingleInstance::forward({ program }, 100)) {
+        out << "An instance of QtTwoButtonsApp is already running; close it first\n";
+        return 1;
+    }
+
+    QVector<double> cold;
+    QVector<double> warm;
+    for (int run = 0; run < ColdRuns; ++run) {
+        QProcess instance;
+        const double coldMs = coldLaunch(instance, program);
+        if (coldMs < 0) {
+            out << "QtTwoButtonsApp did not start: " << instance.errorString() << "\n";
+            stopInstance(instance);
+            return 1;
+        }
+        cold.append(coldMs);
+
+        for (int i = 0; i < WarmRuns / ColdRuns; ++i) {
+            warm.append(warmLaunch(program));
+        }
+        stopInstance(instance);
+    }
+
+    const Summary coldSummary = summarize(cold);
+    const Summary warmSummary = summarize(warm);
+    out << "launch  runs    min ms  median ms    max ms\n";
+    out << QString("cold  %1 %2 %3 %4\n").arg(cold.size(), 6).arg(coldSummary.minMs, 9, 'f', 1)
+               .arg(coldSummary.medianMs, 10, 'f', 1).arg(coldSummary.maxMs, 9, 'f', 1);
+    out << QString("warm  %1 %2 %3 %4\n").arg(warm.size(), 6).arg(warmSummary.minMs, 9, 'f', 1)
+               .arg(warmSummary.medianMs, 10, 'f', 1).arg(warmSummary.maxMs, 9, 'f', 1);
+    return 0;
+}
@@ -0,0 +1,283 @@
+// QBENCHMARK suite for the MainWindow hot paths: construction from the .ui
+// files and from code, style sheet apply, tab switch, click-to-dialog,
+// filtering a large action list and diffing a window-sized snapshot.
+// Besides the QtTest log, the mean time per case is written as JSON to
+// $QTTWOBUTTONS_BENCH_JSON (default bench_results.json) so runs on different
+// commits can be compared.
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QSignalSpy>
+#include <QStyleFactory>
+#include <QTabWidget>
+#include <QtTest>
+
+#include "mainwindow.h"
+#include "actionlistmodel.h"
+#include "imagediff.h"
+
+namespace {
+
+// Accumulates the time spent inside one QBENCHMARK body
+class CaseTimer
+{
+public:
+    void start() { m_timer.start(); }
+    void stop()
+    {
+        m_totalNs += m_timer.nsecsElapsed();
+        ++m_iterations;
+    }
+
+    qint64 iterations() const { return m_iterations; }
+    double meanMs() const { return m_iterations ? m_totalNs / 1e6 / m_iterations : 0; }
+
+private:
+    QElapsedTimer m_timer;
+    qint64 m_totalNs = 0;
+    qint64 m_iterations = 0;
+};
+
+QString readStyles()
+{
+    QFile file(":/styles.qss");
+    if (!file.open(QFile::ReadOnly | QFile::Text)) {
+        return QString();
+    }
+    return QString::fromUtf8(file.readAll());
+}
+
+} // namespace
+
+class MainWindowBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void constructDynamicUI();
+    void constructFallbackUI();
+    void applyStylesheet();
+    void switchTab();
+    void clickToDialog();
+    void filterActionList();
+    void diffSnapshot();
+
+private:
+    void record(const char *name, const CaseTimer &timer);
+
+    QJsonArray m_results;
+};
+
+void MainWindowBench::initTestCase()
+{
+    QApplication::setStyle(QStyleFactory::create("Fusion"));
+}
+
+void MainWindowBench::cleanupTestCase()
+{
+    QJsonObject root;
+    root.insert("platform", QGuiApplication::platformName());
+    root.insert("qtVersion", QString::fromLatin1(qVersion()));
+    root.insert("results", m_results);
+
+    const QString path = qEnvironmentVariable("QTTWOBUTTONS_BENCH_JSON", "bench_results.json");
+    QFile file(path);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+        qWarning() << "Cannot write benchmark results to" << path;
+        return;
+    }
+    file.write(QJsonDocument(root).toJson());
+    qDebug() << "Benchmark results written to" << path;
+}
+
+void MainWindowBench::record(const char *name, const CaseTimer &timer)
+{
+    QJsonObject result;
+    result.insert("name", QString::fromLatin1(name));
+    result.insert("iterations", timer.iterations());
+    result.insert("meanMs", timer.meanMs());
+    m_results.append(result);
+}
+
+void MainWindowBench::constructDynamicUI()
+{
+    MainWindowOptions options;
+    options.dynamicUI = true;
+
+    CaseTimer timer;
+    QBENCHMARK {
+        timer.start();
+        MainWindow window(options);
+        timer.stop();
+    }
+    record("constructDynamicUI", timer);
+}
+
+void MainWindowBench::constructFallbackUI()
+{
+    MainWindowOptions options;
+    options.fallbackUI = true;
+
+    CaseTimer timer;
+    QBENCHMARK {
+        timer.start();
+        MainWindow window(options);
+        timer.stop();
+    }
+    record("constructFallbackUI", timer);
+}
+
+void MainWindowBench::applyStylesheet()
+{
+    MainWindow window;
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+
+    const QString styles = readStyles();
+    QVERIFY(!styles.isEmpty());
+
+    CaseTimer timer;
+    QBENCHMARK {
+        timer.start();
+        window.applyStylesheet(styles);
+        // Force the polish that the next paint would do
+        window.ensurePolished();
+        QApplication::processEvents();
+        timer.stop();
+    }
+    record("applyStylesheet", timer);
+}
+
+void MainWindowBench::switchTab()
+{
+    MainWindow window;
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+
+    QTabWidget *tabWidget = window.findChild<QTabWidget*>("tabWidget");
+    QVERIFY(tabWidget);
+
+    // Build every tab first so only the switch itself is measured
+    for (int i = 0; i < tabWidget->count(); ++i) {
+        tabWidget->setCurrentIndex(i);
+    }
+
+    int index = 0;
+    CaseTimer timer;
+    QBENCHMARK {
+        index = (index + 1) % tabWidget->count();
+        timer.start();
+        tabWidget->setCurrentIndex(index);
+        tabWidget->repaint();
+        timer.stop();
+    }
+    record("switchTab", timer);
+}
+
+void MainWindowBench::clickToDialog()
+{
+    MainWindow window;
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+
+    QTabWidget *tabWidget = window.findChild<QTabWidget*>("tabWidget");
+    QVERIFY(tabWidget);
+    tabWidget->setCurrentWidget(tabWidget->findChild<QWidget*>("destructiveTab"));
+
+    QPushButton *button = window.findChild<QPushButton*>("destructiveButton");
+    QVERIFY(button);
+
+    QSignalSpy shown(window.dialogs(), &DialogService::dialogShown);
+
+    CaseTimer timer;
+    QBENCHMARK {
+        timer.start();
+        QTest::mouseClick(button, Qt::LeftButton);
+        QVERIFY(shown.count() > 0 || shown.wait(1000));
+        timer.stop();
+        shown.clear();
+
+        // Dismiss without confirming so no action runs between iterations
+        QMessageBox *dialog = window.findChild<QMessageBox*>("destructiveDialog");
+        QVERIFY(dialog);
+        dialog->done(QMessageBox::No);
+        QApplication::processEvents();
+    }
+    record("clickToDialog", timer);
+}
+
+void MainWindowBench::filterActionList()
+{
+    // Production-sized catalog for the model/view mode
+    const int actionCount = 10000;
+    static const char *const Variants[] = { "primary", "secondary", "destructive" };
+
+    QList<ActionDefinition> actions;
+    actions.reserve(actionCount);
+    for (int i = 0; i < actionCount; ++i) {
+        ActionDefinition action;
+        action.id = QString("action%1").arg(i);
+        action.label = QString("Catalog Action %1").arg(i);
+        action.variant = Variants[i % 3];
+        actions.append(action);
+    }
+
+    ActionListModel model;
+    model.setActions(actions);
+    ActionFilterModel proxy;
+    proxy.setSourceModel(&model);
+    proxy.setVariant(IosStyle::Secondary);
+
+    const QString filters[] = { "action 12", "" };
+    int filter = 0;
+    CaseTimer timer;
+    QBENCHMARK {
+        timer.start();
+        proxy.setFilterText(filters[filter]);
+        timer.stop();
+        filter = 1 - filter;
+    }
+    record("filterActionList", timer);
+}
+
+void MainWindowBench::diffSnapshot()
+{
+    // A grab of the main window against a golden image one pixel off
+    QImage actual(500, 700, QImage::Format_ARGB32);
+    actual.fill(QColor(0xf2, 0xf2, 0xf7));
+    QImage expected = actual.copy();
+    expected.setPixel(250, 350, qRgb(0x00, 0x7a, 0xff));
+
+    ImageDiffResult result;
+    CaseTimer timer;
+    QBENCHMARK {
+        timer.start();
+        result = ImageDiff::compare(actual, expected, 2);
+        timer.stop();
+    }
+    QCOMPARE(result.differingPixels, qint64(1));
+    record("diffSnapshot", timer);
+}
+
+int main(int argc, char *argv[])
+{
+    // Run headless unless a platform was asked for explicitly
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QApplication app(argc, argv);
+    MainWindowBench bench;
+    return QTest::qExec(&bench, argc, argv);
+}
+
+#include "mainwindowbench.moc"
@@ -0,0 +1,106 @@
+// Measures per-frame paint time of a tab card while its buttons cycle through
+// normal, hover and pressed states, drawn through styles.qss on Fusion versus
+// natively by IosStyle, with and without its render cache.
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFrame>
+#include <QImage>
+#include <QLabel>
+#include <QList>
+#include <QPushButton>
+#include <QStyleFactory>
+#include <QTextStream>
+#include <QVBoxLayout>
+
+#include "iosstyle.h"
+#include "rendercache.h"
+#include "stylesheetcache.h"
+
+namespace {
+
+const int FrameCount = 600;
+
+QString readCardSheet()
+{
+    QFile file(":/styles.qss");
+    if (!file.open(QFile::ReadOnly | QFile::Text)) {
+        return QString();
+    }
+    return StyleSheetCache::split(QString::fromUtf8(file.readAll())).value("card");
+}
+
+// Returns the average time in microseconds to render one frame
+double measure(const QString &cardSheet)
+{
+    QFrame card;
+    card.setObjectName("card");
+    QVBoxLayout *layout = new QVBoxLayout(&card);
+
+    QLabel *description = new QLabel("This is the primary action tab.", &card);
+    description->setObjectName("primaryDescription");
+    layout->addWidget(description);
+
+    QList<QPushButton*> buttons;
+    const char *names[] = { "primaryButton", "secondaryButton", "destructiveButton" };
+    for (const char *name : names) {
+        QPushButton *button = new QPushButton(QString::fromLatin1(name), &card);
+        button->setObjectName(name);
+        layout->addWidget(button);
+        buttons.append(button);
+    }
+
+    card.setStyleSheet(cardSheet);
+    card.resize(460, 420);
+    card.show();
+
+    QImage frame(card.size() * card.devicePixelRatioF(), QImage::Format_ARGB32_Premultiplied);
+    frame.setDevicePixelRatio(card.devicePixelRatioF());
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < FrameCount; ++i) {
+        // Walk the hover and press across the buttons like a pointer would
+        QPushButton *button = buttons.at((i / 3) % buttons.size());
+        const int phase = i % 3;
+        button->setAttribute(Qt::WA_UnderMouse, phase != 0);
+        button->setDown(phase == 2);
+
+        card.render(&frame);
+    }
+    return timer.nsecsElapsed() / 1e3 / FrameCount;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    app.setStyle(QStyleFactory::create("Fusion"));
+    const double qssMicros = measure(readCardSheet());
+
+    app.setStyle(new IosStyle(QStyleFactory::create("Fusion")));
+    const int budget = RenderCache::budget();
+    RenderCache::setBudget(0);
+    const double uncachedMicros = measure(QString());
+
+    RenderCache::setBudget(budget);
+    RenderCache::clear();
+    const double nativeMicros = measure(QString());
+
+    out << "styles.qss on Fusion:    " << qssMicros << " us/frame\n";
+    out << "IosStyle without cache:  " << uncachedMicros << " us/frame\n";
+    out << "IosStyle:                " << nativeMicros << " us/frame\n";
+    out << "Render cache: " << RenderCache::hits() << " hits, " << RenderCache::misses() << " misses, "
+        << RenderCache::size() << " KiB\n";
+
+    // Pixmaps must not outlive QApplication
+    RenderCache::clear();
+    return 0;
+}
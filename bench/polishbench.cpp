@@ -0,0 +1,138 @@
+// Measures style sheet polish time against widget count. Compares the old
+// layout (the whole sheet plus a universal QWidget rule set on the window)
+// with the scoped per-subtree sheets MainWindow applies now.
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFrame>
+#include <QLabel>
+#include <QList>
+#include <QPushButton>
+#include <QTextStream>
+#include <QVBoxLayout>
+
+#include "stylesheetcache.h"
+
+namespace {
+
+const char LegacyUniversalRule[] =
+    "QWidget { background-color: #f2f2f7; color: #1d1d1f; "
+    "font-family: -apple-system, BlinkMacSystemFont, 'Segoe UI', Roboto, sans-serif; font-size: 16px; }";
+
+struct Result
+{
+    int widgetCount = 0;
+    double applyMs = 0;
+    double repolishMs = 0;
+};
+
+QString readStyles()
+{
+    QFile file(":/styles.qss");
+    if (!file.open(QFile::ReadOnly | QFile::Text)) {
+        return QString();
+    }
+    return QString::fromUtf8(file.readAll());
+}
+
+// One card holds a description label and three buttons, like a tab card;
+// each card is paired with an unstyled label outside any card
+void buildTree(QWidget *root, int cardCount, QList<QWidget*> *cards)
+{
+    QVBoxLayout *rootLayout = new QVBoxLayout(root);
+    for (int i = 0; i < cardCount; ++i) {
+        QFrame *card = new QFrame(root);
+        card->setObjectName("card");
+        QVBoxLayout *cardLayout = new QVBoxLayout(card);
+        cardLayout->addWidget(new QLabel("Description", card));
+        cardLayout->addWidget(new QPushButton("Primary Action", card));
+
+        QPushButton *secondary = new QPushButton("Secondary Action", card);
+        secondary->setObjectName("secondaryButton");
+        cardLayout->addWidget(secondary);
+
+        QPushButton *destructive = new QPushButton("Destructive Action", card);
+        destructive->setObjectName("destructiveButton");
+        cardLayout->addWidget(destructive);
+
+        rootLayout->addWidget(card);
+        rootLayout->addWidget(new QLabel("Status", root));
+        cards->append(card);
+    }
+}
+
+Result measure(int cardCount, bool scoped, const QString &cardSheet, const QString &legacySheet)
+{
+    QWidget root;
+    QList<QWidget*> cards;
+    buildTree(&root, cardCount, &cards);
+
+    Result result;
+    result.widgetCount = root.findChildren<QWidget*>().size() + 1;
+
+    QElapsedTimer timer;
+    timer.start();
+    if (scoped) {
+        for (QWidget *card : cards) {
+            card->setStyleSheet(cardSheet);
+        }
+    } else {
+        root.setStyleSheet(legacySheet);
+    }
+    root.ensurePolished();
+    result.applyMs = timer.nsecsElapsed() / 1e6;
+
+    // Re-apply a changed sheet, as a theme edit would
+    timer.restart();
+    if (scoped) {
+        const QString changed = cardSheet + " ";
+        for (QWidget *card : cards) {
+            card->setStyleSheet(changed);
+        }
+    } else {
+        root.setStyleSheet(legacySheet + " ");
+    }
+    root.ensurePolished();
+    result.repolishMs = timer.nsecsElapsed() / 1e6;
+
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    const QString styles = readStyles();
+    const StyleSheetCache::ScopedSheets sheets = StyleSheetCache::split(styles);
+
+    QString legacySheet = QString::fromLatin1(LegacyUniversalRule);
+    for (const QString &sheet : sheets) {
+        legacySheet += QLatin1Char(' ') + sheet;
+    }
+
+    QTextStream out(stdout);
+    out << "widgets\tlegacy apply ms\tlegacy repolish ms\tscoped apply ms\tscoped repolish ms\n";
+
+    const int cardCounts[] = { 10, 50, 100, 250, 500, 1000 };
+    for (int cardCount : cardCounts) {
+        const Result legacy = measure(cardCount, false, sheets.value("card"), legacySheet);
+        const Result scoped = measure(cardCount, true, sheets.value("card"), legacySheet);
+        out << legacy.widgetCount << '\t'
+            << legacy.applyMs << '\t' << legacy.repolishMs << '\t'
+            << scoped.applyMs << '\t' << scoped.repolishMs << '\n';
+        out.flush();
+    }
+
+    // Splitting the same content again is served from the cache
+    StyleSheetCache::split(styles);
+    out << "stylesheet cache: " << StyleSheetCache::hits() << " hits, "
+        << StyleSheetCache::misses() << " misses\n";
+
+    return 0;
+}
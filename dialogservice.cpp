@@ -0,0 +1,176 @@
+#include "dialogservice.h"
+
+#include <QAbstractButton>
+#include <QDebug>
+#include <QEvent>
+
+#include "logcategories.h"
+#include "metrics.h"
+
+DialogService::DialogService(QWidget *parentWindow)
+    : QObject(parentWindow)
+    , m_parentWindow(parentWindow)
+{
+    m_prewarmTimer.setSingleShot(true);
+    m_prewarmTimer.setInterval(0);
+    connect(&m_prewarmTimer, &QTimer::timeout, this, &DialogService::prewarmNext);
+}
+
+void DialogService::setStyleSheet(const QString &styleSheet)
+{
+    m_styleSheet = styleSheet;
+    for (PooledDialog &entry : m_pool) {
+        entry.dialog->setStyleSheet(m_styleSheet);
+    }
+}
+
+void DialogService::prewarm(const QString &objectName, QMessageBox::Icon icon,
+                            QMessageBox::StandardButtons buttons)
+{
+    m_prewarmQueue.append({ objectName, icon, buttons });
+    if (!m_prewarmTimer.isActive()) {
+        m_prewarmTimer.start();
+    }
+}
+
+void DialogService::prewarmNext()
+{
+    if (m_prewarmQueue.isEmpty()) {
+        return;
+    }
+
+    const PrewarmRequest request = m_prewarmQueue.takeFirst();
+    PooledDialog &entry = dialogFor(request.objectName);
+    if (!entry.dialog->isVisible()) {
+        entry.dialog->setIcon(request.icon);
+        entry.dialog->setStandardButtons(request.buttons);
+        entry.dialog->ensurePolished();
+        for (QAbstractButton *button : entry.dialog->buttons()) {
+            button->ensurePolished();
+        }
+    }
+
+    // One dialog per idle pass so input is never held up for long
+    if (!m_prewarmQueue.isEmpty()) {
+        m_prewarmTimer.start();
+    }
+}
+
+DialogService::PooledDialog &DialogService::dialogFor(const QString &objectName)
+{
+    auto it = m_pool.find(objectName);
+    if (it != m_pool.end()) {
+        return it.value();
+    }
+
+    QMessageBox *dialog = new QMessageBox(m_parentWindow);
+    dialog->setObjectName(objectName);
+    dialog->setStyleSheet(m_styleSheet);
+    dialog->installEventFilter(this);
+    connect(dialog, &QMessageBox::buttonClicked, this, [this, objectName]() {
+        m_pool[objectName].closeTimer.start();
+    });
+    connect(dialog, &QMessageBox::finished, this, [this, objectName]() {
+        onDialogFinished(objectName);
+    });
+
+    PooledDialog &entry = m_pool[objectName];
+    entry.dialog = dialog;
+    return entry;
+}
+
+void DialogService::show(const DialogRequest &request, ResultHandler onFinished)
+{
+    PooledDialog &entry = dialogFor(request.objectName);
+    if (entry.dialog->isVisible() || !entry.pending.isEmpty()) {
+        qCDebug(lcDialogs) << "Dialog already open, queued:" << request.objectName;
+        entry.pending.append({ request, std::move(onFinished) });
+        return;
+    }
+
+    open(entry, request, std::move(onFinished));
+}
+
+void DialogService::open(PooledDialog &entry, const DialogRequest &request, ResultHandler onFinished)
+{
+    entry.shownTimer.start();
+    entry.awaitingPaint = true;
+    entry.onFinished = std::move(onFinished);
+
+    // Window-modal and asynchronous: the main event loop is never re-entered
+    prepare(request)->open();
+}
+
+QMessageBox *DialogService::prepare(const DialogRequest &request)
+{
+    QMessageBox *dialog = dialogFor(request.objectName).dialog;
+    dialog->setWindowTitle(request.title);
+    dialog->setText(request.text);
+    dialog->setInformativeText(request.informativeText);
+    dialog->setIcon(request.icon);
+    dialog->setStandardButtons(request.buttons);
+    return dialog;
+}
+
+QMessageBox *DialogService::pooledDialog(const QString &objectName) const
+{
+    auto it = m_pool.constFind(objectName);
+    return it != m_pool.cend() ? it->dialog : nullptr;
+}
+
+void DialogService::onDialogFinished(const QString &objectName)
+{
+    auto it = m_pool.find(objectName);
+    if (it == m_pool.end()) {
+        return;
+    }
+
+    QMessageBox *dialog = it->dialog;
+    const QMessageBox::StandardButton result = dialog->standardButton(dialog->clickedButton());
+    const ResultHandler onFinished = std::move(it->onFinished);
+    it->onFinished = ResultHandler();
+
+    // Closed without a button click, e.g. with Escape or done()
+    QElapsedTimer closeTimer = it->closeTimer;
+    it->closeTimer.invalidate();
+    if (!closeTimer.isValid()) {
+        closeTimer.start();
+    }
+
+    // The handler may open another dialog and grow the pool, so it runs last
+    if (onFinished) {
+        onFinished(result);
+    }
+
+    MetricsRegistry::histogram("qttwobuttons_dialog_close_seconds",
+                               "Time from a dialog button click until the dialog is hidden and its result handled",
+                               { { "dialog", objectName.isEmpty() ? QStringLiteral("default") : objectName } })
+        ->observe(closeTimer.nsecsElapsed());
+
+    // The handler may have shown this dialog again itself; the queue waits then
+    it = m_pool.find(objectName);
+    if (!it->pending.isEmpty() && !it->dialog->isVisible()) {
+        PendingRequest next = it->pending.takeFirst();
+        open(it.value(), next.request, std::move(next.onFinished));
+    }
+}
+
+bool DialogService::eventFilter(QObject *watched, QEvent *event)
+{
+    if (event->type() == QEvent::Paint) {
+        QMessageBox *dialog = qobject_cast<QMessageBox*>(watched);
+        auto it = dialog ? m_pool.find(dialog->objectName()) : m_pool.end();
+        if (it != m_pool.end() && it->awaitingPaint) {
+            it->awaitingPaint = false;
+            const qint64 latencyNs = it->shownTimer.nsecsElapsed();
+            qCDebug(lcDialogs) << "Dialog" << dialog->objectName() << "visible after"
+                     << latencyNs / 1e6 << "ms";
+            MetricsRegistry::histogram("qttwobuttons_dialog_open_seconds", "Time from showing a dialog to its first paint",
+                                       { { "dialog", dialog->objectName().isEmpty() ? QStringLiteral("default")
+                                                                                    : dialog->objectName() } })
+                ->observe(latencyNs);
+            emit dialogShown(dialog->objectName(), latencyNs);
+        }
+    }
+    return QObject::eventFilter(watched, event);
+}
@@ -0,0 +1,101 @@
+#ifndef DIALOGSERVICE_H
+#define DIALOGSERVICE_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMessageBox>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+#include <functional>
+
+struct DialogRequest
+{
+    // Selects the pooled instance and its style variant (e.g. "destructiveDialog2")
+    QString objectName;
+    QString title;
+    QString text;
+    QString informativeText;
+    QMessageBox::Icon icon = QMessageBox::Information;
+    QMessageBox::StandardButtons buttons = QMessageBox::Ok;
+};
+
+// Shows message boxes without nested event loops. One QMessageBox per object
+// name is kept alive and polished, optionally ahead of time, and is shown with
+// open(); the clicked button is delivered through a callback once it finishes.
+// A request for a dialog that is already open waits until it closes, so
+// e.g. two actions finishing at once show both their completions in turn.
+class DialogService : public QObject
+{
+    Q_OBJECT
+
+public:
+    using ResultHandler = std::function<void(QMessageBox::StandardButton)>;
+
+    explicit DialogService(QWidget *parentWindow);
+
+    // Applied to every pooled dialog, now and when created
+    void setStyleSheet(const QString &styleSheet);
+
+    // Creates and polishes the dialog for objectName when the event loop is idle
+    void prewarm(const QString &objectName, QMessageBox::Icon icon, QMessageBox::StandardButtons buttons);
+
+    void show(const DialogRequest &request, ResultHandler onFinished = ResultHandler());
+
+    // Sets up the pooled dialog for request without showing it, e.g. to
+    // render it offscreen
+    QMessageBox *prepare(const DialogRequest &request);
+
+    // The pooled dialog for objectName, or null if none was created yet. Many
+    // requests share the unnamed dialog, so look dialogs up here rather than
+    // with findChild().
+    QMessageBox *pooledDialog(const QString &objectName) const;
+
+signals:
+    // Time from show() to the first paint of the dialog
+    void dialogShown(const QString &objectName, qint64 latencyNs);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    struct PendingRequest
+    {
+        DialogRequest request;
+        ResultHandler onFinished;
+    };
+
+    struct PooledDialog
+    {
+        QMessageBox *dialog = nullptr;
+        ResultHandler onFinished;
+        // Shown one after another once the dialog is closed
+        QList<PendingRequest> pending;
+        QElapsedTimer shownTimer;
+        bool awaitingPaint = false;
+        // From the click on one of its buttons until the result handler returned
+        QElapsedTimer closeTimer;
+    };
+
+    struct PrewarmRequest
+    {
+        QString objectName;
+        QMessageBox::Icon icon;
+        QMessageBox::StandardButtons buttons;
+    };
+
+    PooledDialog &dialogFor(const QString &objectName);
+    void open(PooledDialog &entry, const DialogRequest &request, ResultHandler onFinished);
+    void prewarmNext();
+    void onDialogFinished(const QString &objectName);
+
+    QWidget *m_parentWindow;
+    QString m_styleSheet;
+    QHash<QString, PooledDialog> m_pool;
+    QList<PrewarmRequest> m_prewarmQueue;
+    QTimer m_prewarmTimer;
+};
+
+#endif // DIALOGSERVICE_H
@@ -0,0 +1,114 @@
+#include "eventrecorder.h"
+
+#include <QAbstractButton>
+#include <QApplication>
+#include <QDebug>
+#include <QEvent>
+#include <QMessageBox>
+#include <QTabBar>
+#include <QTabWidget>
+
+#include "logcategories.h"
+#include "mainwindow.h"
+
+namespace {
+
+// Qt's own sub-widgets (e.g. qt_tabwidget_stackedwidget) are not inputs
+const QLatin1String InternalPrefix("qt_");
+
+} // namespace
+
+EventRecorder::EventRecorder(MainWindow *window, QObject *parent) : QObject(parent), m_window(window)
+{
+}
+
+EventRecorder::~EventRecorder()
+{
+    stop();
+}
+
+bool EventRecorder::start(const QString &path)
+{
+    if (!m_writer.open(path)) {
+        return false;
+    }
+    m_clock.start();
+
+    for (QAbstractButton *button : m_window->findChildren<QAbstractButton *>()) {
+        watchButton(button);
+    }
+    if (QTabWidget *tabWidget = m_window->tabWidget()) {
+        connect(tabWidget, &QTabWidget::currentChanged, this, &EventRecorder::onTabChanged);
+    }
+    qApp->installEventFilter(this);
+
+    qCInfo(lcUi) << "Recording events to" << path;
+    return true;
+}
+
+void EventRecorder::stop()
+{
+    if (!m_writer.isOpen()) {
+        return;
+    }
+    if (qApp) {
+        qApp->removeEventFilter(this);
+    }
+    m_writer.close();
+}
+
+bool EventRecorder::eventFilter(QObject *watched, QEvent *event)
+{
+    if (event->type() == QEvent::Polish) {
+        if (QAbstractButton *button = qobject_cast<QAbstractButton *>(watched)) {
+            watchButton(button);
+        }
+    } else if (event->type() == QEvent::Show) {
+        if (QMessageBox *dialog = qobject_cast<QMessageBox *>(watched)) {
+            connect(dialog, &QMessageBox::buttonClicked, this, &EventRecorder::onDialogButtonClicked,
+                    Qt::UniqueConnection);
+        }
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+void EventRecorder::watchButton(QAbstractButton *button)
+{
+    // Dialog buttons are recorded as the dialog's answer instead, and the tab
+    // bar's scroll arrows only move the bar
+    if (button->window() != m_window || button->objectName().isEmpty()
+        || button->objectName().startsWith(InternalPrefix) || qobject_cast<QTabBar *>(button->parent())) {
+        return;
+    }
+    connect(button, &QAbstractButton::clicked, this, &EventRecorder::onButtonClicked, Qt::UniqueConnection);
+}
+
+void EventRecorder::onButtonClicked()
+{
+    record(RecordedEvent::ButtonClick, sender()->objectName());
+}
+
+void EventRecorder::onTabChanged(int index)
+{
+    const QTabWidget *tabWidget = static_cast<QTabWidget *>(sender());
+    if (const QWidget *page = tabWidget->widget(index)) {
+        record(RecordedEvent::TabSwitch, page->objectName());
+    }
+}
+
+void EventRecorder::onDialogButtonClicked(QAbstractButton *button)
+{
+    const QMessageBox *dialog = static_cast<QMessageBox *>(sender());
+    record(RecordedEvent::DialogResponse, dialog->objectName(), quint32(dialog->standardButton(button)));
+}
+
+void EventRecorder::record(RecordedEvent::Type type, const QString &name, quint32 value)
+{
+    RecordedEvent event;
+    event.type = type;
+    event.timeUs = m_clock.nsecsElapsed() / 1000;
+    event.name = name;
+    event.value = value;
+    m_writer.append(event);
+    qCDebug(lcUi) << "Recorded" << int(type) << name << value << "at" << event.timeUs << "us";
+}
@@ -0,0 +1,47 @@
+#ifndef EVENTRECORDER_H
+#define EVENTRECORDER_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+
+#include "eventstream.h"
+
+class MainWindow;
+class QAbstractButton;
+
+// Records input on the main window for --record-events: clicks on named
+// buttons, tab switches and the button each dialog was answered with, with
+// timestamps, into an event stream that EventReplayer plays back.
+//
+// Buttons built later (lazy tabs) are picked up when they are polished, which
+// happens before they can first be shown and clicked.
+class EventRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit EventRecorder(MainWindow *window, QObject *parent = nullptr);
+    ~EventRecorder() override;
+
+    bool start(const QString &path);
+    void stop();
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private slots:
+    void onButtonClicked();
+    void onTabChanged(int index);
+    void onDialogButtonClicked(QAbstractButton *button);
+
+private:
+    void watchButton(QAbstractButton *button);
+    void record(RecordedEvent::Type type, const QString &name, quint32 value = 0);
+
+    MainWindow *m_window;
+    EventStreamWriter m_writer;
+    QElapsedTimer m_clock;
+};
+
+#endif // EVENTRECORDER_H
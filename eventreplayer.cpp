@@ -0,0 +1,254 @@
+#include "eventreplayer.h"
+
+#include <QAbstractButton>
+#include <QApplication>
+#include <QDebug>
+#include <QEvent>
+#include <QMessageBox>
+#include <QMouseEvent>
+#include <QTabBar>
+#include <QTabWidget>
+#include <QTextStream>
+
+#include "logcategories.h"
+#include "mainwindow.h"
+
+namespace {
+
+// Posted behind each input; its delivery marks the input as handled
+const QEvent::Type HandledEvent = QEvent::Type(QEvent::registerEventType());
+
+// How long a recorded dialog response waits for its dialog to open
+const int DialogTimeoutMs = 2000;
+
+QString formatMs(qint64 micros)
+{
+    return QString::number(micros / 1000.0, 'f', 2);
+}
+
+} // namespace
+
+EventReplayer::EventReplayer(MainWindow *window, QObject *parent) : QObject(parent), m_window(window)
+{
+    m_dispatchTimer.setSingleShot(true);
+    m_dispatchTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_dispatchTimer, &QTimer::timeout, this, &EventReplayer::dispatchNext);
+
+    m_dialogTimeout.setSingleShot(true);
+    m_dialogTimeout.setInterval(DialogTimeoutMs);
+    connect(&m_dialogTimeout, &QTimer::timeout, this, [this]() {
+        qCWarning(lcUi) << "Replay: dialog" << m_awaitedDialog << "did not open";
+        m_awaitingDialog = false;
+        m_awaitedDialog.clear();
+        skipCurrent();
+    });
+}
+
+bool EventReplayer::start(const ReplayOptions &options)
+{
+    m_options = options;
+    m_options.loops = qMax(1, m_options.loops);
+    if (!EventStreamReader::read(m_options.path, &m_events)) {
+        return false;
+    }
+    if (m_events.isEmpty()) {
+        qCWarning(lcUi) << "No events to replay in" << m_options.path;
+        return false;
+    }
+
+    qCInfo(lcUi) << "Replaying" << m_events.size() << "events from" << m_options.path
+                 << (m_options.fast ? "as fast as possible" : "at the recorded pace") << "x" << m_options.loops;
+    qApp->installEventFilter(this);
+    m_clock.start();
+    scheduleNext();
+    return true;
+}
+
+void EventReplayer::scheduleNext()
+{
+    if (m_next == m_events.size()) {
+        if (++m_loop >= m_options.loops) {
+            finish();
+            return;
+        }
+        m_next = 0;
+    }
+    if (m_next == 0) {
+        m_loopStartUs = m_clock.nsecsElapsed() / 1000;
+    }
+
+    qint64 delayMs = 0;
+    if (!m_options.fast) {
+        // Relative to the first input, so idle time before it is not replayed
+        const qint64 dueUs = m_loopStartUs + m_events.at(m_next).timeUs - m_events.first().timeUs;
+        delayMs = qMax<qint64>(0, (dueUs - m_clock.nsecsElapsed() / 1000) / 1000);
+    }
+    m_dispatchTimer.start(int(delayMs));
+}
+
+void EventReplayer::dispatchNext()
+{
+    const RecordedEvent &event = m_events.at(m_next);
+    switch (event.type) {
+    case RecordedEvent::ButtonClick: {
+        QAbstractButton *button = m_window->findChild<QAbstractButton *>(event.name);
+        if (!button || !button->isVisible() || !button->isEnabled()) {
+            qCDebug(lcUi) << "Replay: button" << event.name << "is not clickable";
+            skipCurrent();
+            return;
+        }
+        postClick(button, button->rect().center());
+        break;
+    }
+    case RecordedEvent::TabSwitch: {
+        QTabWidget *tabWidget = m_window->tabWidget();
+        int index = -1;
+        for (int i = 0; tabWidget && i < tabWidget->count(); ++i) {
+            if (tabWidget->widget(i)->objectName() == event.name) {
+                index = i;
+                break;
+            }
+        }
+        if (index < 0) {
+            qCDebug(lcUi) << "Replay: no tab" << event.name;
+            skipCurrent();
+            return;
+        }
+        postClick(tabWidget->tabBar(), tabWidget->tabBar()->tabRect(index).center());
+        break;
+    }
+    case RecordedEvent::DialogResponse: {
+        QMessageBox *dialog = m_window->dialogs()->pooledDialog(event.name);
+        if (!dialog || !dialog->isVisible()) {
+            // Opened by a handler that has not run yet, e.g. once a background
+            // action completes; eventFilter() resumes when it shows
+            m_awaitingDialog = true;
+            m_awaitedDialog = event.name;
+            m_dialogTimeout.start();
+            return;
+        }
+        QAbstractButton *button = dialog->button(QMessageBox::StandardButton(event.value));
+        if (!button) {
+            qCDebug(lcUi) << "Replay: dialog" << event.name << "has no button" << event.value;
+            skipCurrent();
+            return;
+        }
+        postClick(button, button->rect().center());
+        break;
+    }
+    }
+
+    m_inFlight = true;
+    m_postedNs = m_clock.nsecsElapsed();
+    QCoreApplication::postEvent(this, new QEvent(HandledEvent));
+}
+
+void EventReplayer::postClick(QWidget *target, const QPoint &position)
+{
+    const QPointF local(position);
+    const QPointF global(target->mapToGlobal(position));
+    QCoreApplication::postEvent(target, new QMouseEvent(QEvent::MouseButtonPress, local, global, Qt::LeftButton,
+                                                        Qt::LeftButton, Qt::NoModifier));
+    QCoreApplication::postEvent(target, new QMouseEvent(QEvent::MouseButtonRelease, local, global, Qt::LeftButton,
+                                                        Qt::NoButton, Qt::NoModifier));
+}
+
+bool EventReplayer::responseComesNext(const QString &dialogName) const
+{
+    // Responses recorded right after the input that opened the dialog
+    for (int i = m_next + (m_inFlight ? 1 : 0);
+         i < m_events.size() && m_events.at(i).type == RecordedEvent::DialogResponse; ++i) {
+        if (m_events.at(i).name == dialogName) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void EventReplayer::skipCurrent()
+{
+    ++m_missed;
+    ++m_next;
+    scheduleNext();
+}
+
+void EventReplayer::finish()
+{
+    m_elapsedNs = m_clock.nsecsElapsed();
+    qApp->removeEventFilter(this);
+    emit finished();
+}
+
+bool EventReplayer::eventFilter(QObject *watched, QEvent *event)
+{
+    ++m_loopEvents;
+
+    if (event->type() == QEvent::Show) {
+        if (QMessageBox *dialog = qobject_cast<QMessageBox *>(watched)) {
+            // Acted on once open() has returned and the dialog has set up its
+            // escape button
+            if (m_awaitingDialog && dialog == m_window->dialogs()->pooledDialog(m_awaitedDialog)) {
+                m_dialogTimeout.stop();
+                m_awaitingDialog = false;
+                m_awaitedDialog.clear();
+                QTimer::singleShot(0, this, &EventReplayer::dispatchNext);
+            } else if (!responseComesNext(dialog->objectName())) {
+                QTimer::singleShot(0, dialog, [this, dialog]() {
+                    QAbstractButton *button = dialog->escapeButton() ? dialog->escapeButton() : dialog->defaultButton();
+                    if (!button && !dialog->buttons().isEmpty()) {
+                        button = dialog->buttons().first();
+                    }
+                    if (button && dialog->isVisible()) {
+                        postClick(button, button->rect().center());
+                        ++m_autoAnswered;
+                    }
+                });
+            }
+        }
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+void EventReplayer::customEvent(QEvent *event)
+{
+    if (event->type() != HandledEvent || !m_inFlight) {
+        return;
+    }
+    const qint64 latencyUs = (m_clock.nsecsElapsed() - m_postedNs) / 1000;
+    m_latency[m_events.at(m_next).type - RecordedEvent::ButtonClick].record(latencyUs);
+    m_allLatency.record(latencyUs);
+
+    m_inFlight = false;
+    ++m_next;
+    scheduleNext();
+}
+
+void EventReplayer::writeReport(QTextStream &out) const
+{
+    const double seconds = qMax<qint64>(m_elapsedNs, 1) / 1e9;
+    out << "Replayed " << m_allLatency.count() << " of " << m_events.size() * m_options.loops << " inputs in "
+        << QString::number(seconds, 'f', 3) << " s (" << m_options.loops << " loop(s), "
+        << (m_options.fast ? "as fast as possible" : "recorded pace") << "), " << m_missed << " skipped, "
+        << m_autoAnswered << " dialogs auto-answered\n";
+    out << "Throughput: " << QString::number(m_allLatency.count() / seconds, 'f', 1) << " inputs/s, "
+        << QString::number(m_loopEvents / seconds, 'f', 0) << " events/s through the event loop\n";
+
+    const char *const names[KindCount] = { "click", "tab switch", "dialog answer" };
+    out << QString("%1 %2 %3 %4 %5 %6 %7\n")
+               .arg("input", -16).arg("count", 7).arg("min ms", 9).arg("p50 ms", 9)
+               .arg("p95 ms", 9).arg("p99 ms", 9).arg("max ms", 9);
+    for (int kind = 0; kind <= KindCount; ++kind) {
+        const LatencyHistogram &histogram = kind < KindCount ? m_latency[kind] : m_allLatency;
+        if (kind < KindCount && histogram.count() == 0) {
+            continue;
+        }
+        out << QString("%1 %2 %3 %4 %5 %6 %7\n")
+                   .arg(kind < KindCount ? names[kind] : "all", -16)
+                   .arg(histogram.count(), 7)
+                   .arg(formatMs(histogram.min()), 9)
+                   .arg(formatMs(histogram.percentile(50)), 9)
+                   .arg(formatMs(histogram.percentile(95)), 9)
+                   .arg(formatMs(histogram.percentile(99)), 9)
+                   .arg(formatMs(histogram.max()), 9);
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef EVENTREPLAYER_H
+#define EVENTREPLAYER_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+
+#include "eventstream.h"
+#include "latencyhistogram.h"
+
+class MainWindow;
+class QPoint;
+class QTextStream;
+class QWidget;
+
+struct ReplayOptions
+{
+    QString path;
+    // Dispatch each event as soon as the previous one was handled instead of
+    // at its recorded time
+    bool fast = false;
+    int loops = 1;
+};
+
+// Plays an event stream recorded by EventRecorder back into the main window
+// for --replay-events. Every input is posted to the event loop as a mouse
+// press and release on the button, tab or dialog button it names, so it goes
+// through the same event handling and slots as a real click.
+//
+// An input counts as handled when a marker event posted right behind it is
+// delivered; its latency is the time from posting until then, which includes
+// any backlog the event loop was working through. The next input is not
+// dispatched before that, so a slow handler delays the rest of the recording
+// rather than piling it up.
+//
+// Dialogs are answered with the recorded response. One that opens without a
+// response coming up next (e.g. a completion dialog the recording closed by
+// other means) is answered with its escape or default button.
+class EventReplayer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit EventReplayer(MainWindow *window, QObject *parent = nullptr);
+
+    // False if the stream cannot be read or is empty
+    bool start(const ReplayOptions &options);
+
+    // Throughput, then count, min, p50, p95, p99 and max latency per kind of
+    // input, in milliseconds
+    void writeReport(QTextStream &out) const;
+
+signals:
+    void finished();
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+    void customEvent(QEvent *event) override;
+
+private:
+    // Histograms per RecordedEvent::Type: click, tab switch, dialog answer
+    static const int KindCount = 3;
+
+    void scheduleNext();
+    void dispatchNext();
+    void postClick(QWidget *target, const QPoint &position);
+    bool responseComesNext(const QString &dialogName) const;
+    void skipCurrent();
+    void finish();
+
+    MainWindow *m_window;
+    ReplayOptions m_options;
+    QVector<RecordedEvent> m_events;
+    int m_next = 0;
+    int m_loop = 0;
+    bool m_inFlight = false;
+    // The unnamed dialog has an empty name, so whether one is awaited is kept
+    // apart from its name
+    bool m_awaitingDialog = false;
+    QString m_awaitedDialog;
+
+    QTimer m_dispatchTimer;
+    QTimer m_dialogTimeout;
+    QElapsedTimer m_clock;
+    qint64 m_loopStartUs = 0;
+    qint64 m_postedNs = 0;
+    qint64 m_elapsedNs = 0;
+
+    LatencyHistogram m_latency[KindCount];
+    LatencyHistogram m_allLatency;
+    qint64 m_loopEvents = 0;
+    int m_missed = 0;
+    int m_autoAnswered = 0;
+};
+
+#endif // EVENTREPLAYER_H
@@ -0,0 +1,146 @@
+#include "eventstream.h"
+
+#include <QDebug>
+
+#include "logcategories.h"
+
+namespace {
+
+const QByteArray Magic("QTBE");
+const quint8 Version = 1;
+
+void appendVarint(QByteArray &bytes, quint64 value)
+{
+    while (value >= 0x80) {
+        bytes += char((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    bytes += char(value);
+}
+
+bool readVarint(const QByteArray &bytes, int &position, quint64 *value)
+{
+    *value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (position >= bytes.size()) {
+            return false;
+        }
+        const quint8 byte = quint8(bytes.at(position++));
+        *value |= quint64(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+bool EventStreamWriter::open(const QString &path)
+{
+    m_file.setFileName(path);
+    if (!m_file.open(QFile::WriteOnly | QFile::Truncate)) {
+        qCWarning(lcUi) << "Cannot record events to" << path << "-" << m_file.errorString();
+        return false;
+    }
+    m_names.clear();
+    m_lastTimeUs = 0;
+    m_file.write(Magic + char(Version));
+    m_file.flush();
+    return true;
+}
+
+void EventStreamWriter::append(const RecordedEvent &event)
+{
+    if (!m_file.isOpen()) {
+        return;
+    }
+
+    QByteArray record;
+    record += char(event.type);
+    appendVarint(record, quint64(qMax<qint64>(event.timeUs - m_lastTimeUs, 0)));
+    m_lastTimeUs = qMax(event.timeUs, m_lastTimeUs);
+
+    auto it = m_names.constFind(event.name);
+    if (it != m_names.constEnd()) {
+        appendVarint(record, it.value());
+    } else {
+        const quint32 index = quint32(m_names.size());
+        m_names.insert(event.name, index);
+        const QByteArray name = event.name.toUtf8();
+        appendVarint(record, index);
+        appendVarint(record, quint64(name.size()));
+        record += name;
+    }
+
+    if (event.type == RecordedEvent::DialogResponse) {
+        appendVarint(record, event.value);
+    }
+
+    // Flushed per record: inputs arrive at human pace, and a crash should not
+    // lose the recording that led up to it
+    m_file.write(record);
+    m_file.flush();
+}
+
+void EventStreamWriter::close()
+{
+    m_file.close();
+}
+
+bool EventStreamReader::read(const QString &path, QVector<RecordedEvent> *events)
+{
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly)) {
+        qCWarning(lcUi) << "Cannot read events from" << path << "-" << file.errorString();
+        return false;
+    }
+    const QByteArray bytes = file.readAll();
+    if (!bytes.startsWith(Magic) || bytes.size() <= Magic.size() || quint8(bytes.at(Magic.size())) != Version) {
+        qCWarning(lcUi) << path << "is not a version" << Version << "event stream";
+        return false;
+    }
+
+    QVector<QString> names;
+    qint64 timeUs = 0;
+    int position = Magic.size() + 1;
+    while (position < bytes.size()) {
+        RecordedEvent event;
+        const quint8 type = quint8(bytes.at(position++));
+        if (type < RecordedEvent::ButtonClick || type > RecordedEvent::DialogResponse) {
+            qCWarning(lcUi) << path << "has an unknown event type" << type << "at offset" << position - 1;
+            return false;
+        }
+        event.type = RecordedEvent::Type(type);
+
+        quint64 delta = 0;
+        quint64 index = 0;
+        if (!readVarint(bytes, position, &delta) || !readVarint(bytes, position, &index) || index > quint64(names.size())) {
+            qCWarning(lcUi) << path << "is truncated or corrupt at offset" << position;
+            return false;
+        }
+        if (index == quint64(names.size())) {
+            quint64 length = 0;
+            if (!readVarint(bytes, position, &length) || length > quint64(bytes.size() - position)) {
+                qCWarning(lcUi) << path << "is truncated or corrupt at offset" << position;
+                return false;
+            }
+            names.append(QString::fromUtf8(bytes.constData() + position, int(length)));
+            position += int(length);
+        }
+        timeUs += qint64(delta);
+        event.timeUs = timeUs;
+        event.name = names.at(int(index));
+
+        if (event.type == RecordedEvent::DialogResponse) {
+            quint64 value = 0;
+            if (!readVarint(bytes, position, &value)) {
+                qCWarning(lcUi) << path << "is truncated or corrupt at offset" << position;
+                return false;
+            }
+            event.value = quint32(value);
+        }
+        events->append(event);
+    }
+    return true;
+}
@@ -0,0 +1,57 @@
+#ifndef EVENTSTREAM_H
+#define EVENTSTREAM_H
+
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+// One recorded input on MainWindow. Inputs are kept by meaning (which button,
+// which tab, which dialog answer) rather than as raw mouse events, so a
+// recording still replays after layout or style changes.
+struct RecordedEvent
+{
+    enum Type : quint8 {
+        ButtonClick = 1,   // name: button objectName
+        TabSwitch = 2,     // name: objectName of the tab page
+        DialogResponse = 3 // name: dialog objectName, value: QMessageBox::StandardButton
+    };
+
+    Type type = ButtonClick;
+    // Microseconds since recording started
+    qint64 timeUs = 0;
+    QString name;
+    quint32 value = 0;
+};
+
+// Writes the binary event stream used by --record-events and
+// --replay-events:
+//
+//   header  "QTBE" + version byte
+//   record  type byte, time delta in us, name index[, name], [value]
+//
+// Integers are LEB128 varints. A name index equal to the number of names seen
+// so far introduces a new name (varint length + UTF-8); later records refer to
+// it by index. A click is usually 3-4 bytes.
+class EventStreamWriter
+{
+public:
+    bool open(const QString &path);
+    bool isOpen() const { return m_file.isOpen(); }
+    void append(const RecordedEvent &event);
+    void close();
+
+private:
+    QFile m_file;
+    QHash<QString, quint32> m_names;
+    qint64 m_lastTimeUs = 0;
+};
+
+class EventStreamReader
+{
+public:
+    // False (with a warning) if the file is missing, not a stream or truncated
+    static bool read(const QString &path, QVector<RecordedEvent> *events);
+};
+
+#endif // EVENTSTREAM_H
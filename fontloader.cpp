@@ -0,0 +1,180 @@
+#include "fontloader.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFontDatabase>
+#include <QFontMetrics>
+#include <QRegularExpression>
+#include <QSet>
+#include <QWidget>
+
+#include <thread>
+#include <utility>
+
+#include "logcategories.h"
+#include "startuptracer.h"
+
+const QString FontLoader::UiFamily = QStringLiteral("DejaVu Sans");
+QStringList FontLoader::s_families;
+QHash<QString, QString> FontLoader::s_resolved;
+qint64 FontLoader::s_registrationNs = 0;
+qint64 FontLoader::s_matchingNs = 0;
+
+namespace {
+
+// CSS allows whitespace before the colon and any case in property names
+const QRegularExpression FontFamilyProperty(QStringLiteral("font-family\\s*:"),
+                                            QRegularExpression::CaseInsensitiveOption);
+
+std::thread s_worker;
+
+bool isGenericFamily(const QString &family)
+{
+    return family == QLatin1String("sans-serif") || family == QLatin1String("serif")
+           || family == QLatin1String("monospace") || family == QLatin1String("system-ui");
+}
+
+} // namespace
+
+void FontLoader::start()
+{
+    if (s_worker.joinable()) {
+        return;
+    }
+    s_worker = std::thread(&FontLoader::registerFonts);
+}
+
+bool FontLoader::isLoading()
+{
+    return s_worker.joinable();
+}
+
+void FontLoader::registerFonts()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // QFontDatabase serializes access with a global mutex, so registering from
+    // here is safe; the GUI thread blocks only if it matches a font meanwhile
+    const QStringList files = QDir(QStringLiteral(":/fonts")).entryList({ "*.ttf", "*.otf" }, QDir::Files);
+    for (const QString &file : files) {
+        const int id = QFontDatabase::addApplicationFont(QStringLiteral(":/fonts/") + file);
+        if (id < 0) {
+            qCWarning(lcStartup) << "Cannot register bundled font" << file;
+            continue;
+        }
+        for (const QString &family : QFontDatabase::applicationFontFamilies(id)) {
+            if (!s_families.contains(family)) {
+                s_families.append(family);
+            }
+        }
+    }
+
+    // Registering invalidates the family list; build it again here rather
+    // than on the first text layout of the GUI thread
+    QFontDatabase::families();
+
+    s_registrationNs = timer.nsecsElapsed();
+}
+
+void FontLoader::waitForFinished()
+{
+    if (!s_worker.joinable()) {
+        return;
+    }
+
+    StartupTraceScope trace("FontLoader::waitForFinished");
+    QElapsedTimer timer;
+    timer.start();
+    s_worker.join();
+
+    if (!s_families.contains(UiFamily)) {
+        qCWarning(lcStartup) << "Bundled UI font" << UiFamily << "is missing; registered" << s_families;
+    }
+    qCInfo(lcStartup) << "Fonts: registered" << s_families << "in" << s_registrationNs / 1000 / 1000.0
+                      << "ms, waited" << timer.nsecsElapsed() / 1000 / 1000.0 << "ms";
+}
+
+QString FontLoader::resolveFamilies(const QString &familyList)
+{
+    auto it = s_resolved.constFind(familyList);
+    if (it != s_resolved.constEnd()) {
+        return it.value();
+    }
+
+    waitForFinished();
+
+    QString resolved = UiFamily;
+    const QStringList families = familyList.split(QLatin1Char(','));
+    for (QString family : families) {
+        family = family.trimmed();
+        if (family.size() >= 2 && (family.front() == QLatin1Char('\'') || family.front() == QLatin1Char('"'))) {
+            family = family.mid(1, family.size() - 2);
+        }
+        // The bundled font stands in for generic families
+        if (isGenericFamily(family)) {
+            break;
+        }
+        if (QFontDatabase::hasFamily(family)) {
+            resolved = family;
+            break;
+        }
+    }
+
+    qCDebug(lcStyle) << "Font family list" << familyList << "resolves to" << resolved;
+    s_resolved.insert(familyList, resolved);
+    return resolved;
+}
+
+QString FontLoader::resolveStyleSheet(const QString &styleSheet)
+{
+    QString resolved = styleSheet;
+    int from = 0;
+    QRegularExpressionMatch match;
+    while ((from = resolved.indexOf(FontFamilyProperty, from, &match)) >= 0) {
+        const int start = from + match.capturedLength();
+        int end = start;
+        while (end < resolved.size() && resolved.at(end) != QLatin1Char(';') && resolved.at(end) != QLatin1Char('}')) {
+            ++end;
+        }
+        const QString families = resolved.mid(start, end - start).trimmed();
+        const QString family = QStringLiteral(" \"") + resolveFamilies(families) + QLatin1Char('"');
+        resolved.replace(start, end - start, family);
+        from = start + family.size();
+    }
+    return resolved;
+}
+
+qint64 FontLoader::matchFonts(QWidget *window)
+{
+    {
+        // Style sheet fonts are only set on widgets once they are polished;
+        // show() would do it next anyway
+        StartupTraceScope trace("polish");
+        window->ensurePolished();
+    }
+
+    StartupTraceScope trace("font matching");
+
+    QList<QWidget *> widgets = window->findChildren<QWidget *>();
+    widgets.prepend(window);
+
+    // QFontCache keeps the engines loaded here, so layout and paint at show()
+    // only hit the cache, and this is the matching they would have done
+    QSet<QString> seen;
+    QElapsedTimer timer;
+    timer.start();
+    for (const QWidget *widget : std::as_const(widgets)) {
+        const QFont font = widget->font();
+        if (!widget->isVisibleTo(window) || seen.contains(font.key())) {
+            continue;
+        }
+        seen.insert(font.key());
+        QFontMetrics(font).horizontalAdvance(QStringLiteral("Ag"));
+    }
+    s_matchingNs = timer.nsecsElapsed();
+
+    qCInfo(lcStartup) << "Font matching before show:" << seen.size() << "fonts in"
+                      << s_matchingNs / 1000 / 1000.0 << "ms";
+    return s_matchingNs;
+}
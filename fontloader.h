@@ -0,0 +1,57 @@
+#ifndef FONTLOADER_H
+#define FONTLOADER_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+class QWidget;
+
+// The UI fonts are bundled as resources (fonts.qrc) because the families
+// styles.qss asks for are not installed on Linux hosts. start() registers
+// them with QFontDatabase on a worker thread, together with populating the
+// system font list, so the work overlaps building the main window; anything
+// that measures text or resolves families must call waitForFinished() first
+// (resolveFamilies() does so itself).
+class FontLoader
+{
+public:
+    // Family of the bundled UI font
+    static const QString UiFamily;
+
+    static void start();
+    // Whether the worker has been started and not joined yet
+    static bool isLoading();
+
+    // Joins the worker; logs how long the GUI thread had to wait for it.
+    // Returns immediately when start() was not called.
+    static void waitForFinished();
+
+    // First family of a CSS style list ("-apple-system, 'Segoe UI', sans-serif")
+    // that is installed, or UiFamily; cached per list
+    static QString resolveFamilies(const QString &familyList);
+
+    // Replaces every font-family list in styleSheet with its resolved family,
+    // so the style sheet engine does not fall back through missing families
+    static QString resolveStyleSheet(const QString &styleSheet);
+
+    // Polishes window (so style sheet fonts are set), then loads the font of
+    // every visible widget, one per distinct font, and logs and returns the
+    // time spent matching them. Call it right before the first show(): the
+    // layout there would otherwise do this matching, and afterwards it only
+    // hits QFontCache.
+    static qint64 matchFonts(QWidget *window);
+
+    static qint64 registrationNs() { return s_registrationNs; }
+    static qint64 matchingNs() { return s_matchingNs; }
+
+private:
+    static void registerFonts();
+
+    static QStringList s_families;
+    static QHash<QString, QString> s_resolved;
+    static qint64 s_registrationNs;
+    static qint64 s_matchingNs;
+};
+
+#endif // FONTLOADER_H
@@ -0,0 +1,69 @@
+#include "hotreloader.h"
+
+#include <QFileInfo>
+
+#include <utility>
+
+#include "logcategories.h"
+
+namespace {
+
+const int DebounceMs = 150;
+
+// A replaced file is looked for this many intervals (3 s) before it counts
+// as deleted
+const int MaxMissingChecks = 20;
+
+} // namespace
+
+HotReloader::HotReloader(QObject *parent) : QObject(parent)
+{
+    m_debounce.setSingleShot(true);
+    m_debounce.setInterval(DebounceMs);
+    connect(&m_debounce, &QTimer::timeout, this, &HotReloader::flush);
+    connect(&m_watcher, &QFileSystemWatcher::fileChanged, this, &HotReloader::onFileChanged);
+}
+
+void HotReloader::watch(const QString &path)
+{
+    const QString absolutePath = QFileInfo(path).absoluteFilePath();
+    if (!m_watcher.addPath(absolutePath)) {
+        qCWarning(lcUi) << "Cannot watch for changes:" << absolutePath;
+        return;
+    }
+    qCDebug(lcUi) << "Watching for changes:" << absolutePath;
+}
+
+void HotReloader::onFileChanged(const QString &path)
+{
+    m_pending.insert(path);
+    m_debounce.start();
+}
+
+void HotReloader::flush()
+{
+    const QSet<QString> pending = std::exchange(m_pending, QSet<QString>());
+    for (const QString &path : pending) {
+        if (!QFileInfo::exists(path)) {
+            // Replaced on save and not back yet; try again after the next
+            // interval, unless it has been gone for too long
+            const int checks = ++m_missingChecks[path];
+            if (checks < MaxMissingChecks) {
+                m_pending.insert(path);
+            } else {
+                m_missingChecks.remove(path);
+                qCWarning(lcUi) << "Watched file was deleted, no longer watching:" << path;
+            }
+            continue;
+        }
+        m_missingChecks.remove(path);
+        if (!m_watcher.files().contains(path)) {
+            m_watcher.addPath(path);
+        }
+        emit fileChanged(path);
+    }
+
+    if (!m_pending.isEmpty()) {
+        m_debounce.start();
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef HOTRELOADER_H
+#define HOTRELOADER_H
+
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QTimer>
+
+// Watches files for the --hot-reload developer mode. Changes are debounced,
+// so an editor saving in several steps triggers one reload, and files that
+// editors replace on save (write to a temporary file, then rename) are
+// watched again once they reappear; one that does not come back within a few
+// seconds is dropped.
+class HotReloader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit HotReloader(QObject *parent = nullptr);
+
+    void watch(const QString &path);
+
+signals:
+    void fileChanged(const QString &path);
+
+private:
+    void onFileChanged(const QString &path);
+    void flush();
+
+    QFileSystemWatcher m_watcher;
+    QTimer m_debounce;
+    QSet<QString> m_pending;
+    // Flushes that found each pending file missing
+    QHash<QString, int> m_missingChecks;
+};
+
+#endif // HOTRELOADER_H
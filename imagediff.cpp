@@ -0,0 +1,105 @@
+#include "imagediff.h"
+
+#include <QtAlgorithms>
+
+#include <algorithm>
+#include <cstdlib>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define IMAGEDIFF_SSE2
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define IMAGEDIFF_NEON
+#endif
+
+namespace {
+
+// Compares width 32-bit pixels; adds to differing and raises maxDelta
+void compareRow(const uchar *a, const uchar *b, int width, int tolerance, qint64 &differing, int &maxDelta)
+{
+    int x = 0;
+    int rowMax = 0;
+
+#if defined(IMAGEDIFF_SSE2)
+    const __m128i tolerances = _mm_set1_epi8(char(tolerance));
+    const __m128i zero = _mm_setzero_si128();
+    __m128i deltaMax = zero;
+    for (; x + 4 <= width; x += 4) {
+        const __m128i pixelsA = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + x * 4));
+        const __m128i pixelsB = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + x * 4));
+        const __m128i delta = _mm_or_si128(_mm_subs_epu8(pixelsA, pixelsB), _mm_subs_epu8(pixelsB, pixelsA));
+        deltaMax = _mm_max_epu8(deltaMax, delta);
+        // A channel is over the tolerance when something is left after subtracting
+        // it; a pixel is within when all four of its channels are zero then
+        const __m128i within = _mm_cmpeq_epi32(_mm_subs_epu8(delta, tolerances), zero);
+        differing += 4 - qPopulationCount(quint32(_mm_movemask_ps(_mm_castsi128_ps(within))));
+    }
+    alignas(16) uchar lanes[16];
+    _mm_store_si128(reinterpret_cast<__m128i *>(lanes), deltaMax);
+    rowMax = *std::max_element(lanes, lanes + 16);
+#elif defined(IMAGEDIFF_NEON)
+    const uint8x16_t tolerances = vdupq_n_u8(uint8_t(tolerance));
+    uint8x16_t deltaMax = vdupq_n_u8(0);
+    for (; x + 4 <= width; x += 4) {
+        const uint8x16_t delta = vabdq_u8(vld1q_u8(a + x * 4), vld1q_u8(b + x * 4));
+        deltaMax = vmaxq_u8(deltaMax, delta);
+        const uint32x4_t within = vceqzq_u32(vreinterpretq_u32_u8(vqsubq_u8(delta, tolerances)));
+        differing += 4 - vaddvq_u32(vshrq_n_u32(within, 31));
+    }
+    rowMax = vmaxvq_u8(deltaMax);
+#endif
+
+    for (; x < width; ++x) {
+        bool over = false;
+        for (int channel = 0; channel < 4; ++channel) {
+            const int delta = std::abs(int(a[x * 4 + channel]) - int(b[x * 4 + channel]));
+            rowMax = std::max(rowMax, delta);
+            over = over || delta > tolerance;
+        }
+        differing += over ? 1 : 0;
+    }
+
+    maxDelta = std::max(maxDelta, rowMax);
+}
+
+} // namespace
+
+ImageDiffResult ImageDiff::compare(const QImage &actual, const QImage &expected, int tolerance, QImage *diffImage)
+{
+    ImageDiffResult result;
+    if (actual.size() != expected.size()) {
+        result.sizeMatches = false;
+        return result;
+    }
+
+    // PNG files are written and read back as straight (not premultiplied)
+    // ARGB, so both sides are compared in that format
+    const QImage a = actual.convertToFormat(QImage::Format_ARGB32);
+    const QImage b = expected.convertToFormat(QImage::Format_ARGB32);
+    tolerance = std::clamp(tolerance, 0, 255);
+
+    for (int y = 0; y < a.height(); ++y) {
+        compareRow(a.constScanLine(y), b.constScanLine(y), a.width(), tolerance, result.differingPixels,
+                   result.maxDelta);
+    }
+
+    if (diffImage && result.differingPixels > 0) {
+        *diffImage = QImage(a.size(), QImage::Format_ARGB32);
+        for (int y = 0; y < a.height(); ++y) {
+            const QRgb *actualLine = reinterpret_cast<const QRgb *>(a.constScanLine(y));
+            const QRgb *expectedLine = reinterpret_cast<const QRgb *>(b.constScanLine(y));
+            QRgb *diffLine = reinterpret_cast<QRgb *>(diffImage->scanLine(y));
+            for (int x = 0; x < a.width(); ++x) {
+                const QRgb p = actualLine[x];
+                const QRgb q = expectedLine[x];
+                const bool over = std::abs(qRed(p) - qRed(q)) > tolerance || std::abs(qGreen(p) - qGreen(q)) > tolerance
+                                  || std::abs(qBlue(p) - qBlue(q)) > tolerance
+                                  || std::abs(qAlpha(p) - qAlpha(q)) > tolerance;
+                diffLine[x] = over ? qRgb(255, 0, 0) : qRgba(qRed(q), qGreen(q), qBlue(q), qAlpha(q) / 4);
+            }
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,28 @@
+#ifndef IMAGEDIFF_H
+#define IMAGEDIFF_H
+
+#include <QImage>
+
+struct ImageDiffResult
+{
+    bool sizeMatches = true;
+    // Pixels with at least one channel further apart than the tolerance
+    qint64 differingPixels = 0;
+    // Largest difference of any channel, 0-255
+    int maxDelta = 0;
+};
+
+// Per-pixel comparison of two images in ARGB32, four pixels at a time with
+// SSE2 (x86-64) or NEON (AArch64) and a scalar loop elsewhere and for the
+// tail of each row. Pure function of its inputs, so any number of
+// comparisons can run on worker threads at once.
+class ImageDiff
+{
+public:
+    // tolerance is per channel (0-255). When diffImage is given and pixels
+    // differ, it receives expected faded out with the differing pixels in red.
+    static ImageDiffResult compare(const QImage &actual, const QImage &expected, int tolerance,
+                                   QImage *diffImage = nullptr);
+};
+
+#endif // IMAGEDIFF_H
@@ -0,0 +1,350 @@
+#include "iosstyle.h"
+
+#include <QFrame>
+#include <QLabel>
+#include <QMessageBox>
+#include <QPainter>
+#include <QPainterPath>
+#include <QPushButton>
+#include <QStyleOption>
+#include <QTabBar>
+#include <QTabWidget>
+
+#include "rendercache.h"
+
+const char IosStyle::VariantProperty[] = "iosVariant";
+
+namespace {
+
+// Values mirror styles.qss
+const int ButtonMargin = 8;
+const qreal ButtonRadius = 12;
+const qreal DialogButtonRadius = 8;
+const int CardMargin = 16;
+const qreal CardRadius = 16;
+const qreal TabRadius = 8;
+
+const QColor WindowColor(0xf2, 0xf2, 0xf7);
+const QColor TextColor(0x1d, 0x1d, 0x1f);
+const QColor SecondaryTextColor(0x86, 0x86, 0x8b);
+const QColor AccentColor(0x00, 0x7a, 0xff);
+const QColor CardColor(Qt::white);
+const QColor CardBorderColor(0xe5, 0xe5, 0xea);
+const QColor TabHoverColor(0xe5, 0xe5, 0xea);
+
+void setPixelFont(QWidget *widget, int pixelSize, QFont::Weight weight)
+{
+    QFont font = widget->font();
+    font.setPixelSize(pixelSize);
+    font.setWeight(weight);
+    widget->setFont(font);
+}
+
+void setTextColor(QWidget *widget, const QColor &color)
+{
+    QPalette palette = widget->palette();
+    palette.setColor(QPalette::WindowText, color);
+    widget->setPalette(palette);
+}
+
+} // namespace
+
+IosStyle::IosStyle(QStyle *baseStyle) : QProxyStyle(baseStyle)
+{
+}
+
+IosStyle::Variant IosStyle::variantFor(const QWidget *widget)
+{
+    if (!widget) {
+        return Primary;
+    }
+
+    const QVariant explicitVariant = widget->property(VariantProperty);
+    if (explicitVariant.isValid()) {
+        return variantFromName(explicitVariant.toString());
+    }
+
+    const QString name = widget->objectName();
+    if (name.startsWith(QLatin1String("secondaryButton"))) {
+        return Secondary;
+    }
+    if (name.startsWith(QLatin1String("destructiveButton"))) {
+        return Destructive;
+    }
+
+    if (QMessageBox *messageBox = qobject_cast<QMessageBox*>(widget->window())) {
+        QAbstractButton *button = qobject_cast<QAbstractButton*>(const_cast<QWidget*>(widget));
+        if (button && messageBox->standardButton(button) == QMessageBox::No) {
+            return Secondary;
+        }
+        const QString dialogName = messageBox->objectName();
+        if (dialogName.startsWith(QLatin1String("destructiveDialog"))) {
+            return Destructive;
+        }
+        if (dialogName.startsWith(QLatin1String("secondaryDialog"))) {
+            return Secondary;
+        }
+    }
+
+    return Primary;
+}
+
+IosStyle::Variant IosStyle::variantFromName(const QString &name)
+{
+    if (name == QLatin1String("secondary")) {
+        return Secondary;
+    }
+    if (name == QLatin1String("destructive")) {
+        return Destructive;
+    }
+    return Primary;
+}
+
+const IosStyle::VariantColors &IosStyle::colors(Variant variant)
+{
+    static const VariantColors table[] = {
+        // background, hover, pressed, text, border
+        { AccentColor, QColor(0x00, 0x56, 0xcc), QColor(0x00, 0x44, 0x99), Qt::white, QColor() },
+        { WindowColor, QColor(0xe5, 0xe5, 0xea), QColor(0xd1, 0xd1, 0xd6), AccentColor, QColor(0xd1, 0xd1, 0xd6) },
+        { QColor(0xff, 0x3b, 0x30), QColor(0xd7, 0x00, 0x15), QColor(0xb3, 0x00, 0x00), Qt::white, QColor() }
+    };
+    return table[variant];
+}
+
+void IosStyle::drawButtonShape(QPainter *painter, const QRectF &rect, Variant variant,
+                               QStyle::State state, qreal radius)
+{
+    RenderCache::draw(painter, rect, RenderCache::Button, variant, state, radius,
+                      [variant, state, radius](QPainter *target, const QRectF &targetRect) {
+        const VariantColors &variantColors = colors(variant);
+
+        QColor fill = variantColors.background;
+        if (!(state & State_Enabled)) {
+            fill.setAlphaF(0.4);
+        } else if (state & (State_Sunken | State_On)) {
+            fill = variantColors.pressed;
+        } else if (state & State_MouseOver) {
+            fill = variantColors.hover;
+        }
+
+        target->save();
+        target->setRenderHint(QPainter::Antialiasing);
+        if (variantColors.border.isValid()) {
+            target->setPen(QPen(variantColors.border, 1));
+        } else {
+            target->setPen(Qt::NoPen);
+        }
+        target->setBrush(fill);
+        target->drawRoundedRect(targetRect.adjusted(0.5, 0.5, -0.5, -0.5), radius, radius);
+        target->restore();
+    });
+}
+
+void IosStyle::drawCardShape(QPainter *painter, const QRectF &rect)
+{
+    RenderCache::draw(painter, rect, RenderCache::Card, 0, State_Enabled, CardRadius,
+                      [](QPainter *target, const QRectF &targetRect) {
+        target->save();
+        target->setRenderHint(QPainter::Antialiasing);
+        target->setPen(QPen(CardBorderColor, 1));
+        target->setBrush(CardColor);
+        target->drawRoundedRect(targetRect.adjusted(0.5, 0.5, -0.5, -0.5), CardRadius, CardRadius);
+        target->restore();
+    });
+}
+
+bool IosStyle::isCard(const QWidget *widget)
+{
+    if (!widget || !qobject_cast<const QFrame*>(widget) || qobject_cast<const QLabel*>(widget)) {
+        return false;
+    }
+    const QString name = widget->objectName();
+    return name == QLatin1String("card") || name.endsWith(QLatin1String("Card"));
+}
+
+bool IosStyle::isDialogButton(const QWidget *widget)
+{
+    return widget && qobject_cast<const QMessageBox*>(widget->window());
+}
+
+void IosStyle::polish(QWidget *widget)
+{
+    QProxyStyle::polish(widget);
+
+    if (QPushButton *button = qobject_cast<QPushButton*>(widget)) {
+        button->setAttribute(Qt::WA_Hover);
+        setPixelFont(button, isDialogButton(button) ? 16 : 17, QFont::DemiBold);
+    } else if (QTabBar *tabBar = qobject_cast<QTabBar*>(widget)) {
+        tabBar->setAttribute(Qt::WA_Hover);
+        tabBar->setDrawBase(false);
+        setPixelFont(tabBar, 15, QFont::Medium);
+    } else if (QLabel *label = qobject_cast<QLabel*>(widget)) {
+        const QString name = label->objectName();
+        if (name == QLatin1String("titleLabel")) {
+            setPixelFont(label, 28, QFont::Bold);
+            label->setContentsMargins(0, 20, 0, 20);
+        } else if (name == QLatin1String("subtitleLabel")) {
+            setPixelFont(label, 17, QFont::Normal);
+            setTextColor(label, SecondaryTextColor);
+            label->setContentsMargins(0, 10, 0, 10);
+        } else if (name.endsWith(QLatin1String("Description"))) {
+            setPixelFont(label, 15, QFont::Normal);
+            setTextColor(label, SecondaryTextColor);
+            label->setContentsMargins(10, 10, 10, 10);
+        }
+    } else if (isCard(widget)) {
+        QFrame *frame = static_cast<QFrame*>(widget);
+        frame->setFrameShape(QFrame::StyledPanel);
+        // Outer margin plus the card padding from styles.qss
+        const int padding = frame->objectName() == QLatin1String("headerCard") ? 24 : 20;
+        frame->setContentsMargins(CardMargin + padding, CardMargin + padding,
+                                  CardMargin + padding, CardMargin + padding);
+    } else if (QMessageBox *messageBox = qobject_cast<QMessageBox*>(widget)) {
+        QPalette palette = messageBox->palette();
+        palette.setColor(QPalette::Window, WindowColor);
+        palette.setColor(QPalette::WindowText, TextColor);
+        messageBox->setPalette(palette);
+    }
+}
+
+void IosStyle::unpolish(QWidget *widget)
+{
+    if (qobject_cast<QPushButton*>(widget) || qobject_cast<QTabBar*>(widget)) {
+        widget->setAttribute(Qt::WA_Hover, false);
+    }
+    QProxyStyle::unpolish(widget);
+}
+
+void IosStyle::drawPrimitive(PrimitiveElement element, const QStyleOption *option,
+                             QPainter *painter, const QWidget *widget) const
+{
+    switch (element) {
+    case PE_Frame:
+        if (isCard(widget)) {
+            drawCardShape(painter, QRectF(option->rect).adjusted(CardMargin, CardMargin, -CardMargin, -CardMargin));
+            return;
+        }
+        break;
+    case PE_FrameTabWidget:
+        // The pane has no border and shares the window background
+        if (qobject_cast<const QTabWidget*>(widget)) {
+            return;
+        }
+        break;
+    case PE_FrameFocusRect:
+        if (qobject_cast<const QPushButton*>(widget) || qobject_cast<const QTabBar*>(widget)) {
+            return;
+        }
+        break;
+    default:
+        break;
+    }
+    QProxyStyle::drawPrimitive(element, option, painter, widget);
+}
+
+void IosStyle::drawControl(ControlElement element, const QStyleOption *option,
+                           QPainter *painter, const QWidget *widget) const
+{
+    switch (element) {
+    case CE_PushButtonBevel:
+        if (qobject_cast<const QPushButton*>(widget)) {
+            const bool dialogButton = isDialogButton(widget);
+            const int margin = dialogButton ? 0 : ButtonMargin;
+            drawButtonShape(painter, QRectF(option->rect).adjusted(margin, margin, -margin, -margin),
+                            variantFor(widget), option->state,
+                            dialogButton ? DialogButtonRadius : ButtonRadius);
+            return;
+        }
+        break;
+    case CE_PushButtonLabel:
+        if (const QStyleOptionButton *buttonOption = qstyleoption_cast<const QStyleOptionButton*>(option);
+            buttonOption && qobject_cast<const QPushButton*>(widget)) {
+            QStyleOptionButton labelOption(*buttonOption);
+            labelOption.palette.setColor(QPalette::ButtonText, colors(variantFor(widget)).text);
+            QProxyStyle::drawControl(element, &labelOption, painter, widget);
+            return;
+        }
+        break;
+    case CE_ShapedFrame:
+        if (isCard(widget)) {
+            drawPrimitive(PE_Frame, option, painter, widget);
+            return;
+        }
+        break;
+    case CE_TabBarTabShape:
+        if (qstyleoption_cast<const QStyleOptionTab*>(option)) {
+            QColor fill = CardColor;
+            if (option->state & State_Selected) {
+                fill = WindowColor;
+            } else if (option->state & State_MouseOver) {
+                fill = TabHoverColor;
+            }
+
+            // Round only the top corners by letting the bottom ones fall outside the clip
+            const QRectF rect = QRectF(option->rect).adjusted(2, 0, -2, 0);
+            QPainterPath path;
+            path.addRoundedRect(rect.adjusted(0, 0, 0, TabRadius), TabRadius, TabRadius);
+
+            painter->save();
+            painter->setRenderHint(QPainter::Antialiasing);
+            painter->setClipRect(option->rect);
+            painter->setPen(Qt::NoPen);
+            painter->setBrush(fill);
+            painter->drawPath(path);
+            painter->restore();
+            return;
+        }
+        break;
+    case CE_TabBarTabLabel:
+        if (const QStyleOptionTab *tabOption = qstyleoption_cast<const QStyleOptionTab*>(option)) {
+            QStyleOptionTab labelOption(*tabOption);
+            QColor text = SecondaryTextColor;
+            if (option->state & State_Selected) {
+                text = AccentColor;
+            } else if (option->state & State_MouseOver) {
+                text = TextColor;
+            }
+            labelOption.palette.setColor(QPalette::WindowText, text);
+            QProxyStyle::drawControl(element, &labelOption, painter, widget);
+            return;
+        }
+        break;
+    default:
+        break;
+    }
+    QProxyStyle::drawControl(element, option, painter, widget);
+}
+
+QSize IosStyle::sizeFromContents(ContentsType type, const QStyleOption *option,
+                                 const QSize &size, const QWidget *widget) const
+{
+    switch (type) {
+    case CT_PushButton:
+        if (qobject_cast<const QPushButton*>(widget)) {
+            if (isDialogButton(widget)) {
+                // padding: 12px 20px; min-width: 80px
+                return (size + QSize(40, 24)).expandedTo(QSize(80, 0));
+            }
+            // padding: 16px 24px; min-width: 140px; min-height: 50px; margin: 8px
+            return (size + QSize(48, 32)).expandedTo(QSize(140, 50))
+                   + QSize(2 * ButtonMargin, 2 * ButtonMargin);
+        }
+        break;
+    case CT_TabBarTab:
+        // padding: 12px 20px; min-width: 80px
+        return QProxyStyle::sizeFromContents(type, option, size, widget)
+                   .expandedTo(QSize(80, 0)) + QSize(16, 12);
+    default:
+        break;
+    }
+    return QProxyStyle::sizeFromContents(type, option, size, widget);
+}
+
+int IosStyle::styleHint(StyleHint hint, const QStyleOption *option, const QWidget *widget,
+                        QStyleHintReturn *returnData) const
+{
+    if (hint == SH_TabBar_Alignment) {
+        return Qt::AlignCenter;
+    }
+    return QProxyStyle::styleHint(hint, option, widget, returnData);
+}
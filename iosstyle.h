@@ -0,0 +1,69 @@
+#ifndef IOSSTYLE_H
+#define IOSSTYLE_H
+
+#include <QColor>
+#include <QProxyStyle>
+
+class QPainter;
+
+// Draws the iOS look (rounded button variants, cards and the tab bar) directly
+// with QPainter on top of a base style, so styles.qss is not needed on the
+// paint path. Button variants come from the "iosVariant" property when set,
+// otherwise from the object name (secondaryButton*, destructiveButton*) or,
+// for message box buttons, from the dialog name (secondaryDialog*, destructiveDialog*).
+// Button and card shapes are rasterized once per variant, state and size and
+// then drawn from RenderCache.
+class IosStyle : public QProxyStyle
+{
+public:
+    enum Variant {
+        Primary,
+        Secondary,
+        Destructive
+    };
+
+    // Colors for one variant; border is invalid when the variant has none
+    struct VariantColors
+    {
+        QColor background;
+        QColor hover;
+        QColor pressed;
+        QColor text;
+        QColor border;
+    };
+
+    static const char VariantProperty[];
+
+    explicit IosStyle(QStyle *baseStyle = nullptr);
+
+    static Variant variantFor(const QWidget *widget);
+    // "primary", "secondary" or "destructive"; anything else is Primary
+    static Variant variantFromName(const QString &name);
+    static const VariantColors &colors(Variant variant);
+
+    // Shared with other widgets that paint the same look (e.g. item delegates)
+    static void drawButtonShape(QPainter *painter, const QRectF &rect, Variant variant,
+                                QStyle::State state, qreal radius);
+    static void drawCardShape(QPainter *painter, const QRectF &rect);
+
+    using QProxyStyle::polish;
+    using QProxyStyle::unpolish;
+
+    void polish(QWidget *widget) override;
+    void unpolish(QWidget *widget) override;
+
+    void drawPrimitive(PrimitiveElement element, const QStyleOption *option,
+                       QPainter *painter, const QWidget *widget = nullptr) const override;
+    void drawControl(ControlElement element, const QStyleOption *option,
+                     QPainter *painter, const QWidget *widget = nullptr) const override;
+    QSize sizeFromContents(ContentsType type, const QStyleOption *option,
+                           const QSize &size, const QWidget *widget = nullptr) const override;
+    int styleHint(StyleHint hint, const QStyleOption *option = nullptr, const QWidget *widget = nullptr,
+                  QStyleHintReturn *returnData = nullptr) const override;
+
+private:
+    static bool isCard(const QWidget *widget);
+    static bool isDialogButton(const QWidget *widget);
+};
+
+#endif // IOSSTYLE_H
@@ -0,0 +1,67 @@
+#include "latencyhistogram.h"
+
+#include <QtAlgorithms>
+
+#include <cmath>
+
+void LatencyHistogram::record(qint64 micros)
+{
+    const qint64 value = qBound<qint64>(0, micros, MaxValue);
+    ++m_counts[indexFor(value)];
+    if (m_count == 0 || value < m_min) {
+        m_min = value;
+    }
+    if (value > m_max) {
+        m_max = value;
+    }
+    ++m_count;
+    m_sum += value;
+}
+
+void LatencyHistogram::clear()
+{
+    m_counts.fill(0);
+    m_count = 0;
+    m_sum = 0;
+    m_min = 0;
+    m_max = 0;
+}
+
+qint64 LatencyHistogram::percentile(double percent) const
+{
+    if (m_count == 0) {
+        return 0;
+    }
+
+    const qint64 target = qMax<qint64>(1, qint64(std::ceil(qBound(0.0, percent, 100.0) / 100.0 * m_count)));
+    qint64 seen = 0;
+    for (int i = 0; i < BucketCount; ++i) {
+        seen += m_counts[i];
+        if (seen >= target) {
+            return qMin(highestValueAt(i), m_max);
+        }
+    }
+    return m_max;
+}
+
+int LatencyHistogram::indexFor(qint64 value)
+{
+    if (value < SubBucketCount) {
+        return int(value);
+    }
+    // Values with the same top SubBucketBits - 1 bits below the leading one share a bucket
+    const int leadingBit = 63 - qCountLeadingZeroBits(quint64(value));
+    const int shift = leadingBit - (SubBucketBits - 1);
+    const int subBucket = int(value >> shift);
+    return SubBucketCount + (shift - 1) * HalfSubBucketCount + (subBucket - HalfSubBucketCount);
+}
+
+qint64 LatencyHistogram::highestValueAt(int index)
+{
+    if (index < SubBucketCount) {
+        return index;
+    }
+    const int shift = (index - SubBucketCount) / HalfSubBucketCount + 1;
+    const qint64 subBucket = (index - SubBucketCount) % HalfSubBucketCount + HalfSubBucketCount;
+    return (subBucket << shift) + (qint64(1) << shift) - 1;
+}
@@ -0,0 +1,44 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QtGlobal>
+
+#include <array>
+
+// Fixed-size histogram of latencies in microseconds with HDR-style
+// log-linear buckets: exact below 128 us and within 1/64 (about 1.6%) above,
+// up to MaxValue. Recording is a few integer operations and never allocates.
+class LatencyHistogram
+{
+public:
+    // About 67 s; larger values are clamped
+    static constexpr qint64 MaxValue = (qint64(1) << 26) - 1;
+
+    void record(qint64 micros);
+    void clear();
+
+    qint64 count() const { return m_count; }
+    qint64 min() const { return m_count ? m_min : 0; }
+    qint64 max() const { return m_max; }
+    double mean() const { return m_count ? double(m_sum) / m_count : 0; }
+
+    // Highest value in the bucket that holds the given percentile (0-100)
+    qint64 percentile(double percent) const;
+
+private:
+    static constexpr int SubBucketBits = 7;
+    static constexpr int SubBucketCount = 1 << SubBucketBits;
+    static constexpr int HalfSubBucketCount = SubBucketCount / 2;
+    static constexpr int BucketCount = SubBucketCount + (26 - SubBucketBits) * HalfSubBucketCount;
+
+    static int indexFor(qint64 value);
+    static qint64 highestValueAt(int index);
+
+    std::array<quint32, BucketCount> m_counts = {};
+    qint64 m_count = 0;
+    qint64 m_sum = 0;
+    qint64 m_min = 0;
+    qint64 m_max = 0;
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -0,0 +1,129 @@
+#include "latencymonitor.h"
+
+#include <QAbstractButton>
+#include <QAbstractItemView>
+#include <QApplication>
+#include <QDialog>
+#include <QEvent>
+#include <QFile>
+#include <QMouseEvent>
+#include <QTextStream>
+
+#include "actionlistmodel.h"
+#include "logcategories.h"
+
+namespace {
+
+QString formatMs(qint64 micros)
+{
+    return QString::number(micros / 1000.0, 'f', 2);
+}
+
+} // namespace
+
+LatencyMonitor::LatencyMonitor(QObject *parent) : QObject(parent)
+{
+}
+
+void LatencyMonitor::start()
+{
+    m_clock.start();
+    qApp->installEventFilter(this);
+}
+
+void LatencyMonitor::stop()
+{
+    if (qApp) {
+        qApp->removeEventFilter(this);
+    }
+}
+
+bool LatencyMonitor::eventFilter(QObject *watched, QEvent *event)
+{
+    switch (event->type()) {
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseButtonRelease: {
+        const QString id = actionIdFor(watched, event);
+        if (id.isEmpty()) {
+            break;
+        }
+        const bool press = event->type() == QEvent::MouseButtonPress;
+        Pending &pending = press ? m_press : m_release;
+        pending.name = id + (press ? ".press" : ".release");
+        pending.target = static_cast<QWidget*>(watched);
+        pending.startedNs = m_clock.nsecsElapsed();
+        break;
+    }
+    case QEvent::Show:
+        // A dialog opened while the release was handled is what responds to it
+        if (m_release.startedNs >= 0 && qobject_cast<QDialog*>(watched)) {
+            m_release.target = static_cast<QWidget*>(watched);
+        }
+        break;
+    case QEvent::Paint:
+        if (m_press.startedNs >= 0 && watched == m_press.target) {
+            finish(m_press);
+        }
+        if (m_release.startedNs >= 0 && watched == m_release.target) {
+            finish(m_release);
+        }
+        break;
+    default:
+        break;
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+QString LatencyMonitor::actionIdFor(QObject *watched, QEvent *event)
+{
+    if (QAbstractButton *button = qobject_cast<QAbstractButton*>(watched)) {
+        // Action buttons only, not the buttons inside dialogs
+        return qobject_cast<QDialog*>(button->window()) ? QString() : button->objectName();
+    }
+
+    QWidget *widget = qobject_cast<QWidget*>(watched);
+    QAbstractItemView *view = widget ? qobject_cast<QAbstractItemView*>(widget->parentWidget()) : nullptr;
+    if (view && view->viewport() == widget) {
+        const QPoint position = static_cast<QMouseEvent*>(event)->position().toPoint();
+        return view->indexAt(position).data(ActionListModel::IdRole).toString();
+    }
+    return QString();
+}
+
+void LatencyMonitor::finish(Pending &pending)
+{
+    const qint64 micros = (m_clock.nsecsElapsed() - pending.startedNs) / 1000;
+    m_histograms[pending.name].record(micros);
+    qCDebug(lcUi) << "Input latency" << pending.name << micros / 1000.0 << "ms";
+    pending = Pending();
+}
+
+void LatencyMonitor::writeReport(QTextStream &out) const
+{
+    out << QString("%1 %2 %3 %4 %5 %6 %7\n")
+               .arg("action", -28).arg("count", 7).arg("min ms", 9).arg("p50 ms", 9)
+               .arg("p95 ms", 9).arg("p99 ms", 9).arg("max ms", 9);
+    for (auto it = m_histograms.cbegin(); it != m_histograms.cend(); ++it) {
+        const LatencyHistogram &histogram = it.value();
+        out << QString("%1 %2 %3 %4 %5 %6 %7\n")
+                   .arg(it.key(), -28)
+                   .arg(histogram.count(), 7)
+                   .arg(formatMs(histogram.min()), 9)
+                   .arg(formatMs(histogram.percentile(50)), 9)
+                   .arg(formatMs(histogram.percentile(95)), 9)
+                   .arg(formatMs(histogram.percentile(99)), 9)
+                   .arg(formatMs(histogram.max()), 9);
+    }
+}
+
+bool LatencyMonitor::writeReport(const QString &path) const
+{
+    QFile file(path);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate | QFile::Text)) {
+        qCWarning(lcUi) << "Could not write latency report to:" << path << "-" << file.errorString();
+        return false;
+    }
+    QTextStream out(&file);
+    writeReport(out);
+    return true;
+}
@@ -0,0 +1,60 @@
+#ifndef LATENCYMONITOR_H
+#define LATENCYMONITOR_H
+
+#include <QElapsedTimer>
+#include <QMap>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+
+#include "latencyhistogram.h"
+
+class QTextStream;
+
+// Measures input-to-paint latency per action. An event filter on the
+// application notes when a mouse press or release reaches an action button
+// (or a row of the action list), then waits for the first paint of what
+// responds to it: the dialog that opened, or otherwise the button's own
+// state change. Press and release latencies go into separate histograms per
+// action id ("<id>.press", "<id>.release").
+//
+// Times start when the event is delivered to the application: the
+// timestamp carried by QMouseEvent is in a platform-specific time base
+// (X server time on xcb) and cannot be compared with a monotonic clock.
+class LatencyMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LatencyMonitor(QObject *parent = nullptr);
+
+    void start();
+    void stop();
+
+    const QMap<QString, LatencyHistogram> &histograms() const { return m_histograms; }
+
+    // Count, min, p50, p95, p99 and max per histogram, in milliseconds
+    void writeReport(QTextStream &out) const;
+    bool writeReport(const QString &path) const;
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    struct Pending
+    {
+        QString name;
+        QPointer<QWidget> target;
+        qint64 startedNs = -1;
+    };
+
+    static QString actionIdFor(QObject *watched, QEvent *event);
+    void finish(Pending &pending);
+
+    QElapsedTimer m_clock;
+    Pending m_press;
+    Pending m_release;
+    QMap<QString, LatencyHistogram> m_histograms;
+};
+
+#endif // LATENCYMONITOR_H
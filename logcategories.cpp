@@ -0,0 +1,8 @@
+#include "logcategories.h"
+
+Q_LOGGING_CATEGORY(lcUi, "qttwobuttons.ui", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcStyle, "qttwobuttons.style", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcActions, "qttwobuttons.actions", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcDialogs, "qttwobuttons.dialogs", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcStartup, "qttwobuttons.startup", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcWatchdog, "qttwobuttons.watchdog", QtInfoMsg)
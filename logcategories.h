@@ -0,0 +1,16 @@
+#ifndef LOGCATEGORIES_H
+#define LOGCATEGORIES_H
+
+#include <QLoggingCategory>
+
+// Debug output of these categories is off by default; enable it with e.g.
+// QT_LOGGING_RULES="qttwobuttons.ui.debug=true". Building with
+// QTTWOBUTTONS_DEBUG_OUTPUT=OFF compiles the qCDebug calls out entirely.
+Q_DECLARE_LOGGING_CATEGORY(lcUi)
+Q_DECLARE_LOGGING_CATEGORY(lcStyle)
+Q_DECLARE_LOGGING_CATEGORY(lcActions)
+Q_DECLARE_LOGGING_CATEGORY(lcDialogs)
+Q_DECLARE_LOGGING_CATEGORY(lcStartup)
+Q_DECLARE_LOGGING_CATEGORY(lcWatchdog)
+
+#endif // LOGCATEGORIES_H
@@ -0,0 +1,274 @@
+#include "logsink.h"
+
+#include <QByteArray>
+#include <QMessageLogContext>
+#include <QString>
+
+#include <qplatformdefs.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+const char LogFileFlag[] = "--log-file=";
+const char DefaultPattern[] = "%{time process} %{type} %{if-category}%{category}: %{endif}%{message}";
+
+// 1024 slots of 256 bytes; longer messages are cut and end in TruncatedMarker
+constexpr quint64 SlotCount = 1024;
+constexpr int SlotSize = 256;
+const char TruncatedMarker[] = "...";
+constexpr int TruncatedMarkerLength = sizeof(TruncatedMarker) - 1;
+constexpr int DrainBatchSize = 64 * 1024;
+
+struct Slot
+{
+    // Bounded MPMC queue protocol: equals the position when free for that
+    // position, and the position + 1 once written
+    std::atomic<quint64> sequence;
+    int length;
+    char text[SlotSize];
+};
+
+Slot s_slots[SlotCount];
+std::atomic<quint64> s_enqueuePos{0};
+std::atomic<quint64> s_dequeuePos{0};
+std::atomic<quint64> s_dropped{0};
+std::atomic<bool> s_running{false};
+std::thread s_drainThread;
+// Set by enqueue() when the drain thread may be waiting for messages
+std::atomic<bool> s_pending{false};
+std::mutex s_wakeMutex;
+std::condition_variable s_wakeCondition;
+int s_fd = 2;
+bool s_installed = false;
+
+void writeAll(int fd, const char *data, size_t length)
+{
+    while (length > 0) {
+        const auto written = QT_WRITE(fd, data, length);
+        if (written <= 0) {
+            return;
+        }
+        data += written;
+        length -= size_t(written);
+    }
+}
+
+// Only the first message after the drain thread went idle takes the lock,
+// to wake it; the lock is held just for the notify
+void wakeDrainThread()
+{
+    if (!s_pending.exchange(true, std::memory_order_acq_rel)) {
+        std::lock_guard<std::mutex> lock(s_wakeMutex);
+        s_wakeCondition.notify_one();
+    }
+}
+
+// Never waits for the drain thread; returns false when the buffer is full
+bool enqueue(const char *data, int length)
+{
+    quint64 pos = s_enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot &slot = s_slots[pos & (SlotCount - 1)];
+        const quint64 sequence = slot.sequence.load(std::memory_order_acquire);
+        const qint64 difference = qint64(sequence) - qint64(pos);
+        if (difference == 0) {
+            if (s_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                if (length <= SlotSize - 1) {
+                    slot.length = length;
+                    std::memcpy(slot.text, data, size_t(length));
+                } else {
+                    // Cut at a UTF-8 character boundary and mark the cut
+                    int kept = SlotSize - 1 - TruncatedMarkerLength;
+                    while (kept > 0 && (uchar(data[kept]) & 0xC0) == 0x80) {
+                        --kept;
+                    }
+                    std::memcpy(slot.text, data, size_t(kept));
+                    std::memcpy(slot.text + kept, TruncatedMarker, TruncatedMarkerLength);
+                    slot.length = kept + TruncatedMarkerLength;
+                }
+                // Keep one line per message even when truncated
+                slot.text[slot.length++] = '\n';
+                slot.sequence.store(pos + 1, std::memory_order_release);
+                wakeDrainThread();
+                return true;
+            }
+        } else if (difference < 0) {
+            s_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            pos = s_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+// Only the drain thread (or shutdown, after joining it) dequeues
+int drainBatch(char *buffer, int capacity)
+{
+    int used = 0;
+    quint64 pos = s_dequeuePos.load(std::memory_order_relaxed);
+    while (used + SlotSize <= capacity) {
+        Slot &slot = s_slots[pos & (SlotCount - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != pos + 1) {
+            break;
+        }
+        std::memcpy(buffer + used, slot.text, size_t(slot.length));
+        used += slot.length;
+        slot.sequence.store(pos + SlotCount, std::memory_order_release);
+        ++pos;
+    }
+    s_dequeuePos.store(pos, std::memory_order_relaxed);
+    return used;
+}
+
+// Sleeps until enqueue() or shutdown() wakes it, so an idle sink costs no
+// wakeups
+void drainLoop()
+{
+    static char buffer[DrainBatchSize];
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(s_wakeMutex);
+            s_wakeCondition.wait(lock, []() {
+                return s_pending.load(std::memory_order_acquire) || !s_running.load(std::memory_order_acquire);
+            });
+        }
+        // Cleared before draining, so a message enqueued meanwhile wakes the
+        // next pass instead of being left behind; an exchange, so the slots
+        // written before the flag was set are visible here
+        s_pending.exchange(false, std::memory_order_acq_rel);
+        for (int length = drainBatch(buffer, DrainBatchSize); length > 0;
+             length = drainBatch(buffer, DrainBatchSize)) {
+            writeAll(s_fd, buffer, size_t(length));
+        }
+        if (!s_running.load(std::memory_order_acquire)) {
+            return;
+        }
+    }
+}
+
+void messageHandler(QtMsgType type, const QMessageLogContext &context, const QString &message)
+{
+    const QByteArray line = qFormatLogMessage(type, context, message).toUtf8();
+    // A fatal message is followed by abort(), whose handler dumps the buffer
+    enqueue(line.constData(), line.size());
+}
+
+void crashHandler(int signal)
+{
+    static const char header[] = "--- log messages pending at crash ---\n";
+    writeAll(2, header, sizeof(header) - 1);
+    LogSink::dumpPending(2);
+    if (s_fd != 2) {
+        LogSink::dumpPending(s_fd);
+    }
+
+    std::signal(signal, SIG_DFL);
+    std::raise(signal);
+}
+
+} // namespace
+
+void LogSink::installFromArguments(int argc, char *argv[])
+{
+    const size_t flagLength = std::strlen(LogFileFlag);
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], LogFileFlag, flagLength) == 0 && argv[i][flagLength] != '\0') {
+            install(argv[i] + flagLength);
+            return;
+        }
+    }
+
+    const QByteArray path = qgetenv("QTTWOBUTTONS_LOG_FILE");
+    install(path.isEmpty() ? nullptr : path.constData());
+}
+
+void LogSink::install(const char *path)
+{
+    if (s_installed) {
+        return;
+    }
+    s_installed = true;
+
+    for (quint64 i = 0; i < SlotCount; ++i) {
+        s_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    if (path) {
+        const int fd = QT_OPEN(path, QT_OPEN_WRONLY | QT_OPEN_CREAT | QT_OPEN_TRUNC, 0644);
+        if (fd >= 0) {
+            s_fd = fd;
+        } else {
+            static const char error[] = "Could not open log file, logging to stderr\n";
+            writeAll(2, error, sizeof(error) - 1);
+        }
+    }
+
+    if (qEnvironmentVariableIsEmpty("QT_MESSAGE_PATTERN")) {
+        qSetMessagePattern(DefaultPattern);
+    }
+
+    s_running.store(true, std::memory_order_release);
+    s_drainThread = std::thread(drainLoop);
+    qInstallMessageHandler(messageHandler);
+
+    std::signal(SIGSEGV, crashHandler);
+    std::signal(SIGABRT, crashHandler);
+    std::signal(SIGFPE, crashHandler);
+    std::signal(SIGILL, crashHandler);
+    std::atexit(shutdown);
+}
+
+void LogSink::shutdown()
+{
+    if (!s_running.exchange(false)) {
+        return;
+    }
+    qInstallMessageHandler(nullptr);
+    {
+        std::lock_guard<std::mutex> lock(s_wakeMutex);
+        s_wakeCondition.notify_one();
+    }
+    s_drainThread.join();
+
+    static char buffer[DrainBatchSize];
+    for (int length = drainBatch(buffer, DrainBatchSize); length > 0;
+         length = drainBatch(buffer, DrainBatchSize)) {
+        writeAll(s_fd, buffer, size_t(length));
+    }
+
+    const quint64 droppedCount = dropped();
+    if (droppedCount > 0) {
+        const QByteArray note = "Log buffer overflowed, " + QByteArray::number(droppedCount)
+                                + " messages dropped\n";
+        writeAll(s_fd, note.constData(), size_t(note.size()));
+    }
+    if (s_fd != 2) {
+        QT_CLOSE(s_fd);
+        s_fd = 2;
+    }
+}
+
+void LogSink::dumpPending(int fd)
+{
+    // Reads without consuming, so a slot may be dumped twice if the drain
+    // thread is writing it at the same moment; that is fine for a crash dump
+    const quint64 end = s_enqueuePos.load(std::memory_order_acquire);
+    for (quint64 pos = s_dequeuePos.load(std::memory_order_acquire); pos < end; ++pos) {
+        const Slot &slot = s_slots[pos & (SlotCount - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) == pos + 1) {
+            writeAll(fd, slot.text, size_t(slot.length));
+        }
+    }
+}
+
+quint64 LogSink::dropped()
+{
+    return s_dropped.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,33 @@
+#ifndef LOGSINK_H
+#define LOGSINK_H
+
+#include <QtGlobal>
+
+// Replaces Qt's synchronous message output. Messages are formatted into a
+// fixed ring buffer of 1024 lines, and a background thread drains the buffer
+// to the log file (or stderr), so logging never waits on the terminal or the
+// disk. The thread sleeps while nothing is logged; only the message that
+// wakes it takes a lock, for the notify. Each message is at most 255
+// bytes: longer ones are cut and end in "...". When the buffer is full new
+// messages are dropped and counted. On a crash the messages not yet drained
+// are written out from the signal handler.
+class LogSink
+{
+public:
+    // Looks for --log-file=<file> (or QTTWOBUTTONS_LOG_FILE) and installs the
+    // sink; without either the drain thread writes to stderr. Call it first
+    // in main() so QApplication's own messages are captured too.
+    static void installFromArguments(int argc, char *argv[]);
+    static void install(const char *path = nullptr);
+
+    // Drains what is left and stops the drain thread; also runs at exit
+    static void shutdown();
+
+    // Writes the messages that have not been drained yet to fd. Only uses
+    // async-signal-safe calls, for crash handlers.
+    static void dumpPending(int fd);
+
+    static quint64 dropped();
+};
+
+#endif // LOGSINK_H
@@ -1,520 +1,340 @@
 #include <QApplication>
-#include <QWidget>
-#include <QPushButton>
-#include <QMessageBox>
+#include <QDebug>
+#include <QElapsedTimer>
 #include <QFont>
-#include <QFontDatabase>
+#include <QStandardPaths>
 #include <QStyleFactory>
-#include <QFile>
-#include <QTextStream>
-#include <QDir>
-#include <QDebug>
-#include <QCoreApplication>
-#include <QUiLoader>
-#include <QVBoxLayout>
-#include <QLabel>
 #include <QTabWidget>
-#include <QFrame>
+#include <QTextStream>
 
-class MainWindow : public QWidget
-{
-    Q_OBJECT
+#include "mainwindow.h"
+#include "startuptracer.h"
+#include "iosstyle.h"
+#include "rendercache.h"
+#include "logcategories.h"
+#include "logsink.h"
+#include "stallwatchdog.h"
+#include "latencymonitor.h"
+#include "singleinstance.h"
+#include "fontloader.h"
+#include "snapshotrunner.h"
+#include "metrics.h"
+#include "metricsserver.h"
+#include "memoryreport.h"
+#include "eventrecorder.h"
+#include "eventreplayer.h"
 
-public:
-    MainWindow(QWidget *parent = nullptr) : QWidget(parent)
-    {
-        // Load UI from designer file
-        if (!loadUI()) {
-            qWarning() << "Failed to load UI file, creating fallback UI";
-            createFallbackUI();
-        }
-        
-        // Load additional stylesheet
-        loadStylesheet();
-        
-        // Connect button signals
-        connectSignals();
-        
-        // Set window properties
-        setWindowTitle("iOS Style Qt Application");
-        setFixedSize(500, 700);
-    }
+#include <cstring>
 
-private:
-    bool loadUI()
-    {
-        // Add more comprehensive path detection
-        QStringList searchPaths = {
-            "mainwindow.ui",                                    // Current directory
-            QDir::currentPath() + "/mainwindow.ui",            // Current working directory
-            QCoreApplication::applicationDirPath() + "/mainwindow.ui",  // Executable directory
-            QCoreApplication::applicationDirPath() + "/bin/mainwindow.ui", // Build output directory
-            QCoreApplication::applicationDirPath() + "/../mainwindow.ui", // Parent of executable directory
-            QCoreApplication::applicationDirPath() + "/../../mainwindow.ui", // Grandparent of executable directory
-            "../mainwindow.ui",                                // Parent directory
-            "../../mainwindow.ui",                             // Grandparent directory
-            "../../../mainwindow.ui",                          // Great-grandparent directory
-            QDir::homePath() + "/Projects/qt_two_buttons_app/mainwindow.ui", // Specific project path
-            "C:/Users/vovik/Projects/qt_two_buttons_app/mainwindow.ui"  // Absolute path
-        };
-        
-        qDebug() << "Current working directory:" << QDir::currentPath();
-        qDebug() << "Application directory:" << QCoreApplication::applicationDirPath();
-        qDebug() << "Home directory:" << QDir::homePath();
-        
-        for (const QString &path : searchPaths) {
-            qDebug() << "Trying to load UI from:" << path;
-            QFile uiFile(path);
-            
-            if (uiFile.exists()) {
-                qDebug() << "UI file found at:" << path;
-                if (uiFile.open(QFile::ReadOnly)) {
-                    QUiLoader loader;
-                    QWidget *uiWidget = loader.load(&uiFile, this);
-                    uiFile.close();
-                    
-                    if (uiWidget) {
-                        // Set the loaded UI as the main widget
-                        QVBoxLayout *layout = new QVBoxLayout(this);
-                        layout->addWidget(uiWidget);
-                        layout->setContentsMargins(0, 0, 0, 0);
-                        setLayout(layout);
-                        
-                        // Store references to UI elements
-                        m_primaryButton = uiWidget->findChild<QPushButton*>("primaryButton");
-                        m_primaryButton2 = uiWidget->findChild<QPushButton*>("primaryButton2");
-                        m_primaryButton3 = uiWidget->findChild<QPushButton*>("primaryButton3");
-                        m_secondaryButton = uiWidget->findChild<QPushButton*>("secondaryButton");
-                        m_secondaryButton2 = uiWidget->findChild<QPushButton*>("secondaryButton2");
-                        m_secondaryButton3 = uiWidget->findChild<QPushButton*>("secondaryButton3");
-                        m_destructiveButton = uiWidget->findChild<QPushButton*>("destructiveButton");
-                        m_destructiveButton2 = uiWidget->findChild<QPushButton*>("destructiveButton2");
-                        m_destructiveButton3 = uiWidget->findChild<QPushButton*>("destructiveButton3");
-                        
-                        qDebug() << "UI loaded successfully from:" << path;
-                        qDebug() << "Primary button found:" << (m_primaryButton != nullptr);
-                        qDebug() << "Primary button 2 found:" << (m_primaryButton2 != nullptr);
-                        qDebug() << "Primary button 3 found:" << (m_primaryButton3 != nullptr);
-                        qDebug() << "Secondary button found:" << (m_secondaryButton != nullptr);
-                        qDebug() << "Secondary button 2 found:" << (m_secondaryButton2 != nullptr);
-                        qDebug() << "Secondary button 3 found:" << (m_secondaryButton3 != nullptr);
-                        qDebug() << "Destructive button found:" << (m_destructiveButton != nullptr);
-                        qDebug() << "Destructive button 2 found:" << (m_destructiveButton2 != nullptr);
-                        qDebug() << "Destructive button 3 found:" << (m_destructiveButton3 != nullptr);
-                        
-                        return true;
-                    } else {
-                        qWarning() << "Failed to load UI from:" << path << "- loader failed";
-                    }
-                } else {
-                    qWarning() << "Could not open UI file:" << path << "-" << uiFile.errorString();
-                }
-            } else {
-                qDebug() << "UI file not found at:" << path;
-            }
+int main(int argc, char *argv[])
+{
+    // Log messages go through a ring buffer drained by a background thread;
+    // --log-file=<file> sends them to a file instead of stderr
+    LogSink::installFromArguments(argc, argv);
+    
+    // --single-instance (or QTTWOBUTTONS_SINGLE_INSTANCE=1): when an instance is
+    // already running, hand it the arguments and exit before any UI is built
+    bool singleInstance = qEnvironmentVariableIntValue("QTTWOBUTTONS_SINGLE_INSTANCE") != 0;
+    for (int i = 1; i < argc; ++i) {
+        singleInstance = singleInstance || std::strcmp(argv[i], "--single-instance") == 0;
+    }
+    if (singleInstance) {
+        QCoreApplication forwardingApp(argc, argv);
+        // Held until instance.listen() below, so launches that overlap this
+        // one's startup wait for it and then forward to it
+        SingleInstance::lockStartup();
+        if (SingleInstance::forward(forwardingApp.arguments())) {
+            SingleInstance::unlockStartup();
+            return 0;
         }
-        
-        qWarning() << "Could not load mainwindow.ui from any location";
-        return false;
     }
     
-    void createFallbackUI()
-    {
-        qDebug() << "Creating fallback UI programmatically";
-        
-        // Create main layout
-        QVBoxLayout *mainLayout = new QVBoxLayout(this);
-        mainLayout->setContentsMargins(20, 20, 20, 20);
-        mainLayout->setSpacing(16);
-        
-        // Create header card
-        QFrame *headerCard = new QFrame(this);
-        headerCard->setObjectName("headerCard");
-        QVBoxLayout *headerLayout = new QVBoxLayout(headerCard);
-        
-        QLabel *titleLabel = new QLabel("Settings", this);
-        titleLabel->setObjectName("titleLabel");
-        titleLabel->setAlignment(Qt::AlignCenter);
-        
-        QLabel *subtitleLabel = new QLabel("Navigate through different sections", this);
-        subtitleLabel->setObjectName("subtitleLabel");
-        subtitleLabel->setAlignment(Qt::AlignCenter);
-        subtitleLabel->setWordWrap(true);
-        
-        headerLayout->addWidget(titleLabel);
-        headerLayout->addWidget(subtitleLabel);
-        
-        // Create tab widget
-        QTabWidget *tabWidget = new QTabWidget(this);
-        
-        // Create three tabs with different content
-        createPrimaryTab(tabWidget);
-        createSecondaryTab(tabWidget);
-        createDestructiveTab(tabWidget);
-        
-        // Add widgets to main layout
-        mainLayout->addWidget(headerCard);
-        mainLayout->addWidget(tabWidget);
-        
-        setLayout(mainLayout);
+    // --snapshot=<dir> always renders offscreen, so the images do not depend
+    // on the display the check happens to run on
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--snapshot=", std::strlen("--snapshot=")) == 0) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
     }
     
-    void createPrimaryTab(QTabWidget *tabWidget)
-    {
-        QWidget *tab = new QWidget();
-        QVBoxLayout *layout = new QVBoxLayout(tab);
-        layout->setContentsMargins(20, 20, 20, 20);
-        layout->setSpacing(16);
-        
-        // Create content card
-        QFrame *contentCard = new QFrame(tab);
-        contentCard->setObjectName("card");
-        QVBoxLayout *contentLayout = new QVBoxLayout(contentCard);
-        
-        QLabel *descriptionLabel = new QLabel("This is the primary action tab. Click the buttons below to perform different primary actions.", tab);
-        descriptionLabel->setAlignment(Qt::AlignCenter);
-        descriptionLabel->setWordWrap(true);
-        descriptionLabel->setStyleSheet("QLabel { color: #86868b; font-size: 15px; margin: 10px; }");
-        
-        m_primaryButton = new QPushButton("Primary Action", tab);
-        m_primaryButton2 = new QPushButton("Primary Action 2", tab);
-        m_primaryButton3 = new QPushButton("Primary Action 3", tab);
-        
-        contentLayout->addWidget(descriptionLabel);
-        contentLayout->addWidget(m_primaryButton);
-        contentLayout->addWidget(m_primaryButton2);
-        contentLayout->addWidget(m_primaryButton3);
-        contentLayout->addStretch();
-        
-        layout->addWidget(contentCard);
-        layout->addStretch();
-        
-        tabWidget->addTab(tab, "Primary");
-    }
+    // --trace-startup=<file> writes the startup phases as Chrome trace JSON
+    StartupTracer::enableFromArguments(argc, argv);
     
-    void createSecondaryTab(QTabWidget *tabWidget)
-    {
-        QWidget *tab = new QWidget();
-        QVBoxLayout *layout = new QVBoxLayout(tab);
-        layout->setContentsMargins(20, 20, 20, 20);
-        layout->setSpacing(16);
-        
-        // Create content card
-        QFrame *contentCard = new QFrame(tab);
-        contentCard->setObjectName("card");
-        QVBoxLayout *contentLayout = new QVBoxLayout(contentCard);
-        
-        QLabel *descriptionLabel = new QLabel("This is the secondary action tab. These buttons have different styling with a light background.", tab);
-        descriptionLabel->setAlignment(Qt::AlignCenter);
-        descriptionLabel->setWordWrap(true);
-        descriptionLabel->setStyleSheet("QLabel { color: #86868b; font-size: 15px; margin: 10px; }");
-        
-        m_secondaryButton = new QPushButton("Secondary Action", tab);
-        m_secondaryButton->setObjectName("secondaryButton");
-        m_secondaryButton2 = new QPushButton("Secondary Action 2", tab);
-        m_secondaryButton2->setObjectName("secondaryButton2");
-        m_secondaryButton3 = new QPushButton("Secondary Action 3", tab);
-        m_secondaryButton3->setObjectName("secondaryButton3");
-        
-        contentLayout->addWidget(descriptionLabel);
-        contentLayout->addWidget(m_secondaryButton);
-        contentLayout->addWidget(m_secondaryButton2);
-        contentLayout->addWidget(m_secondaryButton3);
-        contentLayout->addStretch();
-        
-        layout->addWidget(contentCard);
-        layout->addStretch();
-        
-        tabWidget->addTab(tab, "Secondary");
+    // Serving metrics (--metrics-socket[=<path>], --metrics-port=<port>) also
+    // records the startup phases, without writing a trace
+    bool metrics = qEnvironmentVariableIsSet("QTTWOBUTTONS_METRICS_SOCKET")
+                   || qEnvironmentVariableIsSet("QTTWOBUTTONS_METRICS_PORT");
+    for (int i = 1; i < argc; ++i) {
+        metrics = metrics || std::strncmp(argv[i], "--metrics-", std::strlen("--metrics-")) == 0;
+    }
+    if (metrics) {
+        StartupTracer::enableRecording();
     }
     
-    void createDestructiveTab(QTabWidget *tabWidget)
-    {
-        QWidget *tab = new QWidget();
-        QVBoxLayout *layout = new QVBoxLayout(tab);
-        layout->setContentsMargins(20, 20, 20, 20);
-        layout->setSpacing(16);
-        
-        // Create content card
-        QFrame *contentCard = new QFrame(tab);
-        contentCard->setObjectName("card");
-        QVBoxLayout *contentLayout = new QVBoxLayout(contentCard);
-        
-        QLabel *descriptionLabel = new QLabel("This is the destructive action tab. Be careful with these buttons as they will ask for confirmation before proceeding.", tab);
-        descriptionLabel->setAlignment(Qt::AlignCenter);
-        descriptionLabel->setWordWrap(true);
-        descriptionLabel->setStyleSheet("QLabel { color: #86868b; font-size: 15px; margin: 10px; }");
-        
-        m_destructiveButton = new QPushButton("Destructive Action", tab);
-        m_destructiveButton->setObjectName("destructiveButton");
-        m_destructiveButton2 = new QPushButton("Destructive Action 2", tab);
-        m_destructiveButton2->setObjectName("destructiveButton2");
-        m_destructiveButton3 = new QPushButton("Destructive Action 3", tab);
-        m_destructiveButton3->setObjectName("destructiveButton3");
-        
-        contentLayout->addWidget(descriptionLabel);
-        contentLayout->addWidget(m_destructiveButton);
-        contentLayout->addWidget(m_destructiveButton2);
-        contentLayout->addWidget(m_destructiveButton3);
-        contentLayout->addStretch();
-        
-        layout->addWidget(contentCard);
-        layout->addStretch();
-        
-        tabWidget->addTab(tab, "Destructive");
+    StartupTracer::begin("QApplication");
+    QApplication app(argc, argv);
+    StartupTracer::end("QApplication");
+    
+    // Register the bundled UI fonts on a worker thread while the window is
+    // built; only the family name is set here, nothing is matched yet
+    FontLoader::start();
+    QFont uiFont = app.font();
+    uiFont.setFamily(FontLoader::UiFamily);
+    app.setFont(uiFont);
+    
+    // --latency-report[=<file>] measures input-to-paint latency per action and
+    // prints p50/p95/p99 on exit, to stdout or to the file
+    LatencyMonitor latencyMonitor;
+    bool latencyReport = false;
+    QString latencyReportPath;
+    const QString latencyReportFlag = QStringLiteral("--latency-report");
+    for (const QString &argument : app.arguments()) {
+        if (argument == latencyReportFlag) {
+            latencyReport = true;
+        } else if (argument.startsWith(latencyReportFlag + "=")) {
+            latencyReport = true;
+            latencyReportPath = argument.mid(latencyReportFlag.size() + 1);
+        }
+    }
+    if (latencyReport) {
+        latencyMonitor.start();
     }
     
-    void loadStylesheet()
-    {
-        QStringList searchPaths = {
-            "styles.qss",                                    // Current directory
-            QDir::currentPath() + "/styles.qss",            // Current working directory
-            QCoreApplication::applicationDirPath() + "/styles.qss",  // Executable directory
-            QCoreApplication::applicationDirPath() + "/bin/styles.qss", // Build output directory
-            "../styles.qss",                                // Parent directory
-            "../../styles.qss"                              // Grandparent directory
-        };
-        
-        bool stylesheetLoaded = false;
-        
-        for (const QString &path : searchPaths) {
-            QFile file(path);
-            if (file.open(QFile::ReadOnly | QFile::Text)) {
-                QTextStream stream(&file);
-                QString stylesheet = stream.readAll();
-                setStyleSheet(stylesheet);
-                file.close();
-                qDebug() << "Stylesheet loaded successfully from:" << path;
-                stylesheetLoaded = true;
-                break;
-            } else {
-                qDebug() << "Could not open stylesheet from:" << path << "-" << file.errorString();
+    // Counters, gauges and histograms in Prometheus text format, served over
+    // HTTP on a Unix domain socket and/or an opt-in 127.0.0.1 port
+    MetricsServer metricsServer;
+    if (metrics) {
+        QString metricsSocket = qEnvironmentVariable("QTTWOBUTTONS_METRICS_SOCKET");
+        quint16 metricsPort = quint16(qEnvironmentVariableIntValue("QTTWOBUTTONS_METRICS_PORT"));
+        const QString metricsSocketFlag = QStringLiteral("--metrics-socket");
+        const QString metricsPortFlag = QStringLiteral("--metrics-port=");
+        for (const QString &argument : app.arguments()) {
+            if (argument == metricsSocketFlag) {
+                metricsSocket = MetricsServer::defaultSocketPath();
+            } else if (argument.startsWith(metricsSocketFlag + "=")) {
+                metricsSocket = argument.mid(metricsSocketFlag.size() + 1);
+            } else if (argument.startsWith(metricsPortFlag)) {
+                metricsPort = quint16(argument.mid(metricsPortFlag.size()).toUInt());
             }
         }
-        
-        if (!stylesheetLoaded) {
-            qWarning() << "Could not load styles.qss from any location. Using fallback styles.";
-            // Apply minimal fallback styles
-            setStyleSheet(R"(
-                QWidget {
-                    background-color: #f2f2f7;
-                    color: #1d1d1f;
-                    font-family: -apple-system, BlinkMacSystemFont, 'Segoe UI', Roboto, sans-serif;
-                }
-                QPushButton {
-                    background-color: #007aff;
-                    border: none;
-                    border-radius: 12px;
-                    color: white;
-                    padding: 16px 24px;
-                    margin: 8px;
-                }
-                QPushButton:hover {
-                    background-color: #0056cc;
-                }
-            )");
+        if (metricsSocket.isEmpty() && metricsPort == 0) {
+            metricsSocket = MetricsServer::defaultSocketPath();
         }
+        MetricsRegistry::countPaints();
+        metricsServer.start(metricsSocket, metricsPort);
     }
     
-    void connectSignals()
-    {
-        if (m_primaryButton) {
-            connect(m_primaryButton, &QPushButton::clicked, this, &MainWindow::onPrimaryButtonClicked);
-            qDebug() << "Primary button signal connected";
-        } else {
-            qWarning() << "Primary button not found for signal connection";
-        }
-        if (m_primaryButton2) {
-            connect(m_primaryButton2, &QPushButton::clicked, this, &MainWindow::onPrimaryButton2Clicked);
-            qDebug() << "Primary button 2 signal connected";
-        } else {
-            qWarning() << "Primary button 2 not found for signal connection";
-        }
-        if (m_primaryButton3) {
-            connect(m_primaryButton3, &QPushButton::clicked, this, &MainWindow::onPrimaryButton3Clicked);
-            qDebug() << "Primary button 3 signal connected";
-        } else {
-            qWarning() << "Primary button 3 not found for signal connection";
-        }
-        if (m_secondaryButton) {
-            connect(m_secondaryButton, &QPushButton::clicked, this, &MainWindow::onSecondaryButtonClicked);
-            qDebug() << "Secondary button signal connected";
-        } else {
-            qWarning() << "Secondary button not found for signal connection";
-        }
-        if (m_secondaryButton2) {
-            connect(m_secondaryButton2, &QPushButton::clicked, this, &MainWindow::onSecondaryButton2Clicked);
-            qDebug() << "Secondary button 2 signal connected";
-        } else {
-            qWarning() << "Secondary button 2 not found for signal connection";
-        }
-        if (m_secondaryButton3) {
-            connect(m_secondaryButton3, &QPushButton::clicked, this, &MainWindow::onSecondaryButton3Clicked);
-            qDebug() << "Secondary button 3 signal connected";
-        } else {
-            qWarning() << "Secondary button 3 not found for signal connection";
+    // --memory-report[=<file>] lists object counts, style sheets and heap
+    // growth per subtree after startup and after each tab activation
+    const QString memoryReportFlag = QStringLiteral("--memory-report");
+    for (const QString &argument : app.arguments()) {
+        if (argument == memoryReportFlag) {
+            MemoryReport::enable(QString());
+        } else if (argument.startsWith(memoryReportFlag + "=")) {
+            MemoryReport::enable(argument.mid(memoryReportFlag.size() + 1));
         }
-        if (m_destructiveButton) {
-            connect(m_destructiveButton, &QPushButton::clicked, this, &MainWindow::onDestructiveButtonClicked);
-            qDebug() << "Destructive button signal connected";
-        } else {
-            qWarning() << "Destructive button not found for signal connection";
+    }
+    
+    MainWindowOptions options;
+    
+    // Developer override: load mainwindow.ui and styles.qss from disk instead of
+    // the compiled-in copies, so edits show up without a rebuild
+    options.dynamicUI = app.arguments().contains("--dynamic-ui")
+                        || qEnvironmentVariableIntValue("QTTWOBUTTONS_DYNAMIC_UI") != 0;
+    
+    // Developer mode: apply edits to styles.qss and the .ui files while running
+    options.hotReload = app.arguments().contains("--hot-reload")
+                        || qEnvironmentVariableIntValue("QTTWOBUTTONS_HOT_RELOAD") != 0;
+    options.dynamicUI = options.dynamicUI || options.hotReload;
+    
+    // Draw the iOS look with IosStyle instead of going through styles.qss
+    options.nativeStyle = app.arguments().contains("--native-style")
+                          || qEnvironmentVariableIntValue("QTTWOBUTTONS_NATIVE_STYLE") != 0;
+    
+    // Show the actions in a virtualized list per tab instead of one button each
+    options.actionList = app.arguments().contains("--action-list")
+                         || qEnvironmentVariableIntValue("QTTWOBUTTONS_ACTION_LIST") != 0;
+    
+    // --actions=<file> loads another action table, e.g. the production catalog
+    const QString actionsFlag = QStringLiteral("--actions=");
+    for (const QString &argument : app.arguments()) {
+        if (argument.startsWith(actionsFlag)) {
+            options.actionsPath = argument.mid(actionsFlag.size());
         }
-        if (m_destructiveButton2) {
-            connect(m_destructiveButton2, &QPushButton::clicked, this, &MainWindow::onDestructiveButton2Clicked);
-            qDebug() << "Destructive button 2 signal connected";
-        } else {
-            qWarning() << "Destructive button 2 not found for signal connection";
+    }
+    
+    // --snapshot=<dir> grabs every tab, button state and dialog to PNG and
+    // compares them with the images in --golden=<dir>, then exits
+    SnapshotOptions snapshotOptions;
+    const QString snapshotFlag = QStringLiteral("--snapshot=");
+    const QString goldenFlag = QStringLiteral("--golden=");
+    const QString toleranceFlag = QStringLiteral("--snapshot-tolerance=");
+    for (const QString &argument : app.arguments()) {
+        if (argument.startsWith(snapshotFlag)) {
+            snapshotOptions.outputDirectory = argument.mid(snapshotFlag.size());
+        } else if (argument.startsWith(goldenFlag)) {
+            snapshotOptions.goldenDirectory = argument.mid(goldenFlag.size());
+        } else if (argument.startsWith(toleranceFlag)) {
+            snapshotOptions.tolerance = argument.mid(toleranceFlag.size()).toInt();
         }
-        if (m_destructiveButton3) {
-            connect(m_destructiveButton3, &QPushButton::clicked, this, &MainWindow::onDestructiveButton3Clicked);
-            qDebug() << "Destructive button 3 signal connected";
-        } else {
-            qWarning() << "Destructive button 3 not found for signal connection";
+    }
+    
+    // --stall-report[=<file>] reports GUI thread stalls longer than
+    // QTTWOBUTTONS_STALL_MS (250 by default) to the file, or to stalls.jsonl
+    // in the app data directory; setting QTTWOBUTTONS_STALL_MS alone also
+    // turns it on. Snapshots render without an event loop, which would look
+    // like one long stall, so the watchdog stays off for them.
+    bool stallReport = qEnvironmentVariableIntValue("QTTWOBUTTONS_STALL_MS") > 0;
+    QString stallReportPath;
+    const QString stallReportFlag = QStringLiteral("--stall-report");
+    for (const QString &argument : app.arguments()) {
+        if (argument == stallReportFlag) {
+            stallReport = true;
+        } else if (argument.startsWith(stallReportFlag + "=")) {
+            stallReport = true;
+            stallReportPath = argument.mid(stallReportFlag.size() + 1);
         }
     }
-
-private slots:
-    void onPrimaryButtonClicked()
-    {
-        QMessageBox msgBox(this);
-        msgBox.setWindowTitle("Primary Action");
-        msgBox.setText("Primary action completed successfully!");
-        msgBox.setInformativeText("This is the main action of your application.");
-        msgBox.setIcon(QMessageBox::Information);
-        msgBox.setStandardButtons(QMessageBox::Ok);
-        msgBox.exec();
+    if (stallReportPath.isEmpty()) {
+        stallReportPath = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/stalls.jsonl";
     }
-    
-    void onPrimaryButton2Clicked()
-    {
-        QMessageBox msgBox(this);
-        msgBox.setWindowTitle("Primary Action 2");
-        msgBox.setText("Primary action 2 completed successfully!");
-        msgBox.setInformativeText("This is the second primary action of your application.");
-        msgBox.setIcon(QMessageBox::Information);
-        msgBox.setStandardButtons(QMessageBox::Ok);
-        msgBox.exec();
+    const int stallThresholdMs = qEnvironmentVariableIsSet("QTTWOBUTTONS_STALL_MS")
+                                 ? qEnvironmentVariableIntValue("QTTWOBUTTONS_STALL_MS") : 250;
+    StallWatchdog watchdog;
+    if (stallReport && snapshotOptions.outputDirectory.isEmpty()) {
+        watchdog.start(stallReportPath, stallThresholdMs);
     }
     
-    void onPrimaryButton3Clicked()
-    {
-        QMessageBox msgBox(this);
-        msgBox.setWindowTitle("Primary Action 3");
-        msgBox.setText("Primary action 3 completed successfully!");
-        msgBox.setInformativeText("This is the third primary action of your application.");
-        msgBox.setIcon(QMessageBox::Information);
-        msgBox.setStandardButtons(QMessageBox::Ok);
-        msgBox.exec();
+    // --record-events=<file> logs clicks on named buttons, tab switches and
+    // dialog answers; --replay-events=<file> plays them back and exits with a
+    // throughput and latency report (--replay-fast, --replay-loops=<n>)
+    QString recordEventsPath;
+    ReplayOptions replayOptions;
+    const QString recordEventsFlag = QStringLiteral("--record-events=");
+    const QString replayEventsFlag = QStringLiteral("--replay-events=");
+    const QString replayLoopsFlag = QStringLiteral("--replay-loops=");
+    for (const QString &argument : app.arguments()) {
+        if (argument.startsWith(recordEventsFlag)) {
+            recordEventsPath = argument.mid(recordEventsFlag.size());
+        } else if (argument.startsWith(replayEventsFlag)) {
+            replayOptions.path = argument.mid(replayEventsFlag.size());
+        } else if (argument.startsWith(replayLoopsFlag)) {
+            replayOptions.loops = argument.mid(replayLoopsFlag.size()).toInt();
+        } else if (argument == QLatin1String("--replay-fast")) {
+            replayOptions.fast = true;
+        }
     }
     
-    void onSecondaryButtonClicked()
-    {
-        QMessageBox msgBox(this);
-        msgBox.setObjectName("secondaryDialog");
-        msgBox.setWindowTitle("Secondary Action");
-        msgBox.setText("Secondary action completed!");
-        msgBox.setInformativeText("This is a secondary action with different styling.");
-        msgBox.setIcon(QMessageBox::Information);
-        msgBox.setStandardButtons(QMessageBox::Ok);
-        msgBox.exec();
-    }
+    // Set application-wide style to Fusion for better cross-platform consistency
+    StartupTracer::begin("QStyleFactory::create(Fusion)");
+    QStyle *fusionStyle = QStyleFactory::create("Fusion");
+    app.setStyle(options.nativeStyle ? new IosStyle(fusionStyle) : fusionStyle);
+    StartupTracer::end("QStyleFactory::create(Fusion)");
     
-    void onSecondaryButton2Clicked()
-    {
-        QMessageBox msgBox(this);
-        msgBox.setObjectName("secondaryDialog2");
-        msgBox.setWindowTitle("Secondary Action 2");
-        msgBox.setText("Secondary action 2 completed!");
-        msgBox.setInformativeText("This is the second secondary action with different styling.");
-        msgBox.setIcon(QMessageBox::Information);
-        msgBox.setStandardButtons(QMessageBox::Ok);
-        msgBox.exec();
+    // Budget for IosStyle's rasterized button and card shapes, in KiB
+    if (qEnvironmentVariableIsSet("QTTWOBUTTONS_RENDER_CACHE_KIB")) {
+        RenderCache::setBudget(qEnvironmentVariableIntValue("QTTWOBUTTONS_RENDER_CACHE_KIB"));
     }
     
-    void onSecondaryButton3Clicked()
-    {
-        QMessageBox msgBox(this);
-        msgBox.setObjectName("secondaryDialog3");
-        msgBox.setWindowTitle("Secondary Action 3");
-        msgBox.setText("Secondary action 3 completed!");
-        msgBox.setInformativeText("This is the third secondary action with different styling.");
-        msgBox.setIcon(QMessageBox::Information);
-        msgBox.setStandardButtons(QMessageBox::Ok);
-        msgBox.exec();
+    QElapsedTimer startupTimer;
+    startupTimer.start();
+    
+    StartupTracer::begin("MainWindow");
+    MainWindow window(options);
+    StartupTracer::end("MainWindow");
+    
+    // The window was built while the fonts registered; its style sheet font
+    // lists are resolved now, before anything measures text. Layout at show()
+    // would match every font in use, so matchFonts() does that first and
+    // times it on its own.
+    FontLoader::waitForFinished();
+    window.resolveFonts();
+    FontLoader::matchFonts(&window);
+    StartupTracer::finishOnFirstPaint(&window);
+    StartupTracer::begin("show");
+    window.show();
+    StartupTracer::end("show");
+    
+    // Forwarded launches raise this window and act on their arguments
+    SingleInstance instance;
+    if (singleInstance) {
+        QObject::connect(&instance, &SingleInstance::argumentsReceived, &window,
+                         [&app, &window](const QStringList &arguments) {
+            if (arguments.contains("--quit")) {
+                app.quit();
+                return;
+            }
+            window.setWindowState(window.windowState() & ~Qt::WindowMinimized);
+            window.show();
+            window.raise();
+            window.activateWindow();
+            window.activate(arguments);
+        });
+        instance.listen();
     }
     
-    void onDestructiveButtonClicked()
-    {
-        QMessageBox msgBox(this);
-        msgBox.setObjectName("destructiveDialog");
-        msgBox.setWindowTitle("Destructive Action");
-        msgBox.setText("Are you sure you want to perform this action?");
-        msgBox.setInformativeText("This action cannot be undone.");
-        msgBox.setIcon(QMessageBox::Warning);
-        msgBox.setStandardButtons(QMessageBox::Yes | QMessageBox::No);
-        
-        int result = msgBox.exec();
-        if (result == QMessageBox::Yes) {
-            QMessageBox::information(this, "Action Confirmed", "Destructive action has been performed.");
+    // --tab=<name> and --action=<id> work for cold launches too
+    window.activate(app.arguments());
+    
+    if (MemoryReport::isEnabled()) {
+        MemoryReport::write(&window, "after startup");
+        if (QTabWidget *tabWidget = window.tabWidget()) {
+            // Connected after MainWindow's own handler, so the tab is built by now
+            QObject::connect(tabWidget, &QTabWidget::currentChanged, &window, [&window, tabWidget](int index) {
+                MemoryReport::write(&window, "after activating " + tabWidget->widget(index)->objectName());
+            });
         }
     }
     
-    void onDestructiveButton2Clicked()
-    {
-        QMessageBox msgBox(this);
-        msgBox.setObjectName("destructiveDialog2");
-        msgBox.setWindowTitle("Destructive Action 2");
-        msgBox.setText("Are you sure you want to perform this second destructive action?");
-        msgBox.setInformativeText("This action cannot be undone and may have serious consequences.");
-        msgBox.setIcon(QMessageBox::Warning);
-        msgBox.setStandardButtons(QMessageBox::Yes | QMessageBox::No);
-        
-        int result = msgBox.exec();
-        if (result == QMessageBox::Yes) {
-            QMessageBox::information(this, "Action Confirmed", "Second destructive action has been performed.");
-        }
+    EventRecorder recorder(&window);
+    if (!recordEventsPath.isEmpty()) {
+        recorder.start(recordEventsPath);
     }
     
-    void onDestructiveButton3Clicked()
-    {
-        QMessageBox msgBox(this);
-        msgBox.setObjectName("destructiveDialog3");
-        msgBox.setWindowTitle("Destructive Action 3");
-        msgBox.setText("Are you sure you want to perform this third destructive action?");
-        msgBox.setInformativeText("This action cannot be undone and will permanently delete data.");
-        msgBox.setIcon(QMessageBox::Warning);
-        msgBox.setStandardButtons(QMessageBox::Yes | QMessageBox::No);
-        
-        int result = msgBox.exec();
-        if (result == QMessageBox::Yes) {
-            QMessageBox::information(this, "Action Confirmed", "Third destructive action has been performed.");
-        }
+    EventReplayer replayer(&window);
+    bool replayFailed = false;
+    if (!replayOptions.path.isEmpty()) {
+        QObject::connect(&replayer, &EventReplayer::finished, &app, [&replayer]() {
+            QTextStream out(stdout);
+            replayer.writeReport(out);
+            QCoreApplication::quit();
+        });
+        replayFailed = !replayer.start(replayOptions);
     }
-
-private:
-    QPushButton *m_primaryButton = nullptr;
-    QPushButton *m_primaryButton2 = nullptr;
-    QPushButton *m_primaryButton3 = nullptr;
-    QPushButton *m_secondaryButton = nullptr;
-    QPushButton *m_secondaryButton2 = nullptr;
-    QPushButton *m_secondaryButton3 = nullptr;
-    QPushButton *m_destructiveButton = nullptr;
-    QPushButton *m_destructiveButton2 = nullptr;
-    QPushButton *m_destructiveButton3 = nullptr;
-};
-
-int main(int argc, char *argv[])
-{
-    QApplication app(argc, argv);
     
-    // Set application-wide style to Fusion for better cross-platform consistency
-    app.setStyle(QStyleFactory::create("Fusion"));
+    qCInfo(lcStartup) << "Startup (" << (options.dynamicUI ? "dynamic" : "compiled") << "UI ) took"
+                      << startupTimer.elapsed() << "ms";
     
-    MainWindow window;
-    window.show();
+    int exitCode = 0;
+    if (replayFailed) {
+        exitCode = 1;
+    } else if (snapshotOptions.outputDirectory.isEmpty()) {
+        exitCode = app.exec();
+    } else {
+        exitCode = SnapshotRunner(&window).run(snapshotOptions) == 0 ? 0 : 1;
+    }
     
-    return app.exec();
+    if (options.nativeStyle) {
+        qCInfo(lcStyle) << "Render cache:" << RenderCache::hits() << "hits," << RenderCache::misses()
+                        << "misses," << RenderCache::size() << "of" << RenderCache::budget() << "KiB";
+    }
+    // The cached pixmaps must go while QApplication still exists, not during
+    // static destruction
+    RenderCache::clear();
+    
+    if (latencyReport) {
+        latencyMonitor.stop();
+        if (latencyReportPath.isEmpty()) {
+            QTextStream out(stdout);
+            latencyMonitor.writeReport(out);
+        } else {
+            latencyMonitor.writeReport(latencyReportPath);
+        }
+    }
+    
+    recorder.stop();
+    metricsServer.stop();
+    watchdog.stop();
+    LogSink::shutdown();
+    return exitCode;
 }
-
-#include "main.moc"
@@ -0,0 +1,964 @@
+#include "mainwindow.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QFont>
+#include <QFrame>
+#include <QLabel>
+#include <QLineEdit>
+#include <QListView>
+#include <QPalette>
+#include <QPushButton>
+#include <QScopedPointer>
+#include <QShowEvent>
+#include <QTabWidget>
+#include <QTextStream>
+#include <QUiLoader>
+#include <QVBoxLayout>
+
+#include <algorithm>
+
+#include "ui_primarytab.h"
+#include "ui_secondarytab.h"
+#include "ui_destructivetab.h"
+#include "startuptracer.h"
+#include "logcategories.h"
+#include "actionlistmodel.h"
+#include "actiondelegate.h"
+#include "hotreloader.h"
+#include "fontloader.h"
+#include "metrics.h"
+#include "memoryreport.h"
+
+MainWindow::MainWindow(const MainWindowOptions &options, QWidget *parent)
+    : QWidget(parent)
+    , m_dialogs(new DialogService(this))
+    , m_executor(new ActionExecutor(this))
+{
+    MemoryScope memory(this);
+    
+    applyWindowPalette();
+    
+    // Buttons are wired to actions by object name from this table
+    m_actions.load(options.actionsPath);
+    connect(m_executor, &ActionExecutor::progressChanged, this, [this](int, const QString &actionId, int percent) {
+        qCDebug(lcActions) << "Action" << actionId << "progress:" << percent << "%";
+        auto it = m_runningActions.find(actionId);
+        if (it == m_runningActions.end()) {
+            return;
+        }
+        it->percent = percent;
+        updateActionButton(actionId);
+        if (m_actionModel) {
+            m_actionModel->setProgress(actionId, percent);
+        }
+    });
+    connect(m_executor, &ActionExecutor::finished, this, &MainWindow::onActionFinished);
+    
+    if (options.actionList) {
+        m_actionModel = new ActionListModel(this);
+        m_actionModel->setActions(m_actions.actions());
+    }
+    
+    if (options.fallbackUI) {
+        // Build everything programmatically, without any .ui file
+        createFallbackUI();
+        if (!options.nativeStyle) {
+            loadCompiledStylesheet();
+        }
+    } else if (options.dynamicUI) {
+        // Developer override: load UI and stylesheet from disk at runtime
+        if (!loadUI()) {
+            qCWarning(lcUi) << "Failed to load UI file, creating fallback UI";
+            createFallbackUI();
+        }
+        if (!options.nativeStyle) {
+            loadStylesheet();
+        }
+        if (options.hotReload && m_uiSource == UiSource::Dynamic) {
+            setupHotReload();
+        }
+    } else {
+        // Use the UI compiled by uic and the stylesheet embedded as a resource
+        setupCompiledUI();
+        if (!options.nativeStyle) {
+            loadCompiledStylesheet();
+        }
+    }
+    
+    // Only the visible tab is built now; the others are built when first
+    // selected, or ahead of time once the event loop goes idle after show()
+    if (m_tabWidget) {
+        m_tabBuilt.fill(false, m_tabWidget->count());
+        connect(m_tabWidget, &QTabWidget::currentChanged, this, &MainWindow::ensureTabBuilt);
+        ensureTabBuilt(m_tabWidget->currentIndex());
+    } else {
+        qCWarning(lcUi) << "Tab widget not found, tabs will not be built";
+    }
+    
+    m_prebuildTimer.setSingleShot(true);
+    m_prebuildTimer.setInterval(0);
+    connect(&m_prebuildTimer, &QTimer::timeout, this, &MainWindow::prebuildNextTab);
+    
+    // Set window properties
+    setWindowTitle("iOS Style Qt Application");
+    setFixedSize(500, 700);
+}
+
+void MainWindow::activate(const QStringList &arguments)
+{
+    const QString tabFlag = QStringLiteral("--tab=");
+    const QString actionFlag = QStringLiteral("--action=");
+    for (const QString &argument : arguments) {
+        if (argument.startsWith(tabFlag) && m_tabWidget) {
+            const QString tab = argument.mid(tabFlag.size());
+            bool isIndex = false;
+            const int index = tab.toInt(&isIndex);
+            for (int i = 0; i < m_tabWidget->count(); ++i) {
+                if ((isIndex && i == index)
+                    || m_tabWidget->widget(i)->objectName().compare(tab + "Tab", Qt::CaseInsensitive) == 0
+                    || m_tabWidget->tabText(i).compare(tab, Qt::CaseInsensitive) == 0) {
+                    m_tabWidget->setCurrentIndex(i);
+                    break;
+                }
+            }
+        } else if (argument.startsWith(actionFlag)) {
+            const QString id = argument.mid(actionFlag.size());
+            if (m_actions.contains(id)) {
+                triggerAction(id);
+            } else {
+                qCWarning(lcActions) << "No action registered for:" << id;
+            }
+        }
+    }
+}
+
+void MainWindow::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    if (!event->spontaneous() && m_tabBuilt.contains(false)) {
+        m_prebuildTimer.start();
+    }
+}
+
+void MainWindow::setupCompiledUI()
+{
+    StartupTraceScope trace("setupCompiledUI");
+    
+    // Host the generated UI in a child widget so the object tree matches
+    // the one QUiLoader builds in loadUI()
+    QWidget *uiWidget = new QWidget(this);
+    m_ui.setupUi(uiWidget);
+    
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addWidget(uiWidget);
+    layout->setContentsMargins(0, 0, 0, 0);
+    setLayout(layout);
+    
+    m_uiSource = UiSource::Compiled;
+    m_tabWidget = m_ui.tabWidget;
+}
+
+bool MainWindow::loadUI()
+{
+    StartupTraceScope trace("loadUI");
+    
+    // Add more comprehensive path detection
+    QStringList searchPaths = {
+        "mainwindow.ui",                                    // Current directory
+        QDir::currentPath() + "/mainwindow.ui",            // Current working directory
+        QCoreApplication::applicationDirPath() + "/mainwindow.ui",  // Executable directory
+        QCoreApplication::applicationDirPath() + "/bin/mainwindow.ui", // Build output directory
+        QCoreApplication::applicationDirPath() + "/../mainwindow.ui", // Parent of executable directory
+        QCoreApplication::applicationDirPath() + "/../../mainwindow.ui", // Grandparent of executable directory
+        "../mainwindow.ui",                                // Parent directory
+        "../../mainwindow.ui",                             // Grandparent directory
+        "../../../mainwindow.ui",                          // Great-grandparent directory
+        QDir::homePath() + "/Projects/qt_two_buttons_app/mainwindow.ui", // Specific project path
+        "C:/Users/vovik/Projects/qt_two_buttons_app/mainwindow.ui"  // Absolute path
+    };
+    
+    qCDebug(lcUi) << "Current working directory:" << QDir::currentPath();
+    qCDebug(lcUi) << "Application directory:" << QCoreApplication::applicationDirPath();
+    qCDebug(lcUi) << "Home directory:" << QDir::homePath();
+    
+    for (int i = 0; i < searchPaths.size(); ++i) {
+        const QString &path = searchPaths.at(i);
+        StartupTraceScope probeTrace("loadUI probe", i);
+        qCDebug(lcUi) << "Trying to load UI from:" << path;
+        QFile uiFile(path);
+        
+        if (uiFile.exists()) {
+            qCDebug(lcUi) << "UI file found at:" << path;
+            if (uiFile.open(QFile::ReadOnly)) {
+                QUiLoader loader;
+                StartupTracer::begin("QUiLoader::load");
+                QWidget *uiWidget = loader.load(&uiFile, this);
+                StartupTracer::end("QUiLoader::load");
+                uiFile.close();
+                
+                if (uiWidget) {
+                    // Set the loaded UI as the main widget
+                    QVBoxLayout *layout = new QVBoxLayout(this);
+                    layout->addWidget(uiWidget);
+                    layout->setContentsMargins(0, 0, 0, 0);
+                    setLayout(layout);
+                    
+                    // Tab forms are loaded on demand from the same directory
+                    m_uiSource = UiSource::Dynamic;
+                    m_uiDirectory = QFileInfo(path).absoluteDir();
+                    m_tabWidget = uiWidget->findChild<QTabWidget*>("tabWidget");
+                    
+                    qCDebug(lcUi) << "UI loaded successfully from:" << path;
+                    qCDebug(lcUi) << "Tab widget found:" << (m_tabWidget != nullptr);
+                    
+                    return true;
+                } else {
+                    qCWarning(lcUi) << "Failed to load UI from:" << path << "- loader failed";
+                }
+            } else {
+                qCWarning(lcUi) << "Could not open UI file:" << path << "-" << uiFile.errorString();
+            }
+        } else {
+            qCDebug(lcUi) << "UI file not found at:" << path;
+        }
+    }
+    
+    qCWarning(lcUi) << "Could not load mainwindow.ui from any location";
+    return false;
+}
+
+QWidget *MainWindow::loadTabUI(QWidget *page, const QString &fileName)
+{
+    QFile uiFile(m_uiDirectory.filePath(fileName));
+    if (!uiFile.open(QFile::ReadOnly)) {
+        qCWarning(lcUi) << "Could not open UI file:" << uiFile.fileName() << "-" << uiFile.errorString();
+        return nullptr;
+    }
+    
+    QUiLoader loader;
+    QWidget *content = loader.load(&uiFile, page);
+    uiFile.close();
+    
+    if (!content) {
+        qCWarning(lcUi) << "Failed to load UI from:" << uiFile.fileName() << "- loader failed";
+        return nullptr;
+    }
+    
+    QVBoxLayout *layout = new QVBoxLayout(page);
+    layout->addWidget(content);
+    layout->setContentsMargins(0, 0, 0, 0);
+    qCDebug(lcUi) << "Tab UI loaded successfully from:" << uiFile.fileName();
+    return content;
+}
+
+void MainWindow::ensureTabBuilt(int index)
+{
+    if (index < 0 || index >= m_tabBuilt.size() || m_tabBuilt.at(index)) {
+        return;
+    }
+    m_tabBuilt[index] = true;
+    
+    StartupTraceScope trace("buildTab", index);
+    
+    QWidget *page = m_tabWidget->widget(index);
+    MemoryScope memory(page);
+    const QString name = page->objectName();
+    if (m_actionModel) {
+        IosStyle::Variant variant = IosStyle::Primary;
+        if (name == "secondaryTab") {
+            variant = IosStyle::Secondary;
+        } else if (name == "destructiveTab") {
+            variant = IosStyle::Destructive;
+        }
+        buildActionListTab(page, variant);
+    } else if (name == "primaryTab") {
+        buildTab<Ui::PrimaryTab>(page, "primarytab.ui", &MainWindow::createPrimaryTab);
+        connectTabActions(page);
+    } else if (name == "secondaryTab") {
+        buildTab<Ui::SecondaryTab>(page, "secondarytab.ui", &MainWindow::createSecondaryTab);
+        connectTabActions(page);
+    } else if (name == "destructiveTab") {
+        buildTab<Ui::DestructiveTab>(page, "destructivetab.ui", &MainWindow::createDestructiveTab);
+        connectTabActions(page);
+    } else {
+        qCWarning(lcUi) << "No builder for tab:" << name;
+    }
+    
+    page->setStyleSheet(m_styleSheets.value("card"));
+    
+    MetricsRegistry::gauge("qttwobuttons_tab_objects", "QObjects in each built tab page, the page included",
+                           { { "tab", name } })
+        ->set(page->findChildren<QObject*>().size() + 1);
+}
+
+void MainWindow::prebuildNextTab()
+{
+    ensureTabBuilt(m_tabBuilt.indexOf(false));
+    
+    // Build one tab per idle pass so input is never held up for long
+    if (m_tabBuilt.contains(false)) {
+        m_prebuildTimer.start();
+    } else {
+        prewarmDialogs();
+    }
+}
+
+void MainWindow::prewarmDialogs()
+{
+    for (const QString &id : m_actions.ids()) {
+        const ActionDefinition action = m_actions.action(id);
+        if (action.hasConfirmation) {
+            m_dialogs->prewarm(action.confirmation.objectName, action.confirmation.icon,
+                               action.confirmation.buttons);
+        }
+        m_dialogs->prewarm(action.completion.objectName, action.completion.icon, action.completion.buttons);
+    }
+}
+
+template <typename Form>
+void MainWindow::buildTab(QWidget *page, const QString &fileName,
+                          void (MainWindow::*createFallbackTab)(QWidget *))
+{
+    switch (m_uiSource) {
+    case UiSource::Compiled: {
+        Form form;
+        form.setupUi(page);
+        break;
+    }
+    case UiSource::Dynamic:
+        if (loadTabUI(page, fileName)) {
+            break;
+        }
+        qCWarning(lcUi) << "Failed to load" << fileName << "- creating fallback tab";
+        [[fallthrough]];
+    case UiSource::Fallback:
+        (this->*createFallbackTab)(page);
+        break;
+    }
+}
+
+void MainWindow::createFallbackUI()
+{
+    StartupTraceScope trace("createFallbackUI");
+    
+    qCDebug(lcUi) << "Creating fallback UI programmatically";
+    
+    // Create main layout
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    mainLayout->setContentsMargins(20, 20, 20, 20);
+    mainLayout->setSpacing(16);
+    
+    // Create header card
+    QFrame *headerCard = new QFrame(this);
+    headerCard->setObjectName("headerCard");
+    QVBoxLayout *headerLayout = new QVBoxLayout(headerCard);
+    
+    QLabel *titleLabel = new QLabel("Settings", this);
+    titleLabel->setObjectName("titleLabel");
+    titleLabel->setAlignment(Qt::AlignCenter);
+    
+    QLabel *subtitleLabel = new QLabel("Navigate through different sections", this);
+    subtitleLabel->setObjectName("subtitleLabel");
+    subtitleLabel->setAlignment(Qt::AlignCenter);
+    subtitleLabel->setWordWrap(true);
+    
+    headerLayout->addWidget(titleLabel);
+    headerLayout->addWidget(subtitleLabel);
+    
+    // Create tab widget
+    QTabWidget *tabWidget = new QTabWidget(this);
+    tabWidget->setObjectName("tabWidget");
+    
+    // Create three empty tab pages; their content is built by ensureTabBuilt()
+    QWidget *primaryTab = new QWidget();
+    primaryTab->setObjectName("primaryTab");
+    tabWidget->addTab(primaryTab, "Primary");
+    
+    QWidget *secondaryTab = new QWidget();
+    secondaryTab->setObjectName("secondaryTab");
+    tabWidget->addTab(secondaryTab, "Secondary");
+    
+    QWidget *destructiveTab = new QWidget();
+    destructiveTab->setObjectName("destructiveTab");
+    tabWidget->addTab(destructiveTab, "Destructive");
+    
+    m_uiSource = UiSource::Fallback;
+    m_tabWidget = tabWidget;
+    
+    // Add widgets to main layout
+    mainLayout->addWidget(headerCard);
+    mainLayout->addWidget(tabWidget);
+    
+    setLayout(mainLayout);
+}
+
+void MainWindow::createPrimaryTab(QWidget *tab)
+{
+    QVBoxLayout *layout = new QVBoxLayout(tab);
+    layout->setContentsMargins(20, 20, 20, 20);
+    layout->setSpacing(16);
+    
+    // Create content card
+    QFrame *contentCard = new QFrame(tab);
+    contentCard->setObjectName("card");
+    QVBoxLayout *contentLayout = new QVBoxLayout(contentCard);
+    
+    QLabel *descriptionLabel = new QLabel("This is the primary action tab. Click the buttons below to perform different primary actions.", tab);
+    descriptionLabel->setAlignment(Qt::AlignCenter);
+    descriptionLabel->setWordWrap(true);
+    descriptionLabel->setStyleSheet("QLabel { color: #86868b; font-size: 15px; margin: 10px; }");
+    
+    QPushButton *primaryButton = new QPushButton("Primary Action", tab);
+    primaryButton->setObjectName("primaryButton");
+    QPushButton *primaryButton2 = new QPushButton("Primary Action 2", tab);
+    primaryButton2->setObjectName("primaryButton2");
+    QPushButton *primaryButton3 = new QPushButton("Primary Action 3", tab);
+    primaryButton3->setObjectName("primaryButton3");
+    
+    contentLayout->addWidget(descriptionLabel);
+    contentLayout->addWidget(primaryButton);
+    contentLayout->addWidget(primaryButton2);
+    contentLayout->addWidget(primaryButton3);
+    contentLayout->addStretch();
+    
+    layout->addWidget(contentCard);
+    layout->addStretch();
+}
+
+void MainWindow::createSecondaryTab(QWidget *tab)
+{
+    QVBoxLayout *layout = new QVBoxLayout(tab);
+    layout->setContentsMargins(20, 20, 20, 20);
+    layout->setSpacing(16);
+    
+    // Create content card
+    QFrame *contentCard = new QFrame(tab);
+    contentCard->setObjectName("card");
+    QVBoxLayout *contentLayout = new QVBoxLayout(contentCard);
+    
+    QLabel *descriptionLabel = new QLabel("This is the secondary action tab. These buttons have different styling with a light background.", tab);
+    descriptionLabel->setAlignment(Qt::AlignCenter);
+    descriptionLabel->setWordWrap(true);
+    descriptionLabel->setStyleSheet("QLabel { color: #86868b; font-size: 15px; margin: 10px; }");
+    
+    QPushButton *secondaryButton = new QPushButton("Secondary Action", tab);
+    secondaryButton->setObjectName("secondaryButton");
+    QPushButton *secondaryButton2 = new QPushButton("Secondary Action 2", tab);
+    secondaryButton2->setObjectName("secondaryButton2");
+    QPushButton *secondaryButton3 = new QPushButton("Secondary Action 3", tab);
+    secondaryButton3->setObjectName("secondaryButton3");
+    
+    contentLayout->addWidget(descriptionLabel);
+    contentLayout->addWidget(secondaryButton);
+    contentLayout->addWidget(secondaryButton2);
+    contentLayout->addWidget(secondaryButton3);
+    contentLayout->addStretch();
+    
+    layout->addWidget(contentCard);
+    layout->addStretch();
+}
+
+void MainWindow::createDestructiveTab(QWidget *tab)
+{
+    QVBoxLayout *layout = new QVBoxLayout(tab);
+    layout->setContentsMargins(20, 20, 20, 20);
+    layout->setSpacing(16);
+    
+    // Create content card
+    QFrame *contentCard = new QFrame(tab);
+    contentCard->setObjectName("card");
+    QVBoxLayout *contentLayout = new QVBoxLayout(contentCard);
+    
+    QLabel *descriptionLabel = new QLabel("This is the destructive action tab. Be careful with these buttons as they will ask for confirmation before proceeding.", tab);
+    descriptionLabel->setAlignment(Qt::AlignCenter);
+    descriptionLabel->setWordWrap(true);
+    descriptionLabel->setStyleSheet("QLabel { color: #86868b; font-size: 15px; margin: 10px; }");
+    
+    QPushButton *destructiveButton = new QPushButton("Destructive Action", tab);
+    destructiveButton->setObjectName("destructiveButton");
+    QPushButton *destructiveButton2 = new QPushButton("Destructive Action 2", tab);
+    destructiveButton2->setObjectName("destructiveButton2");
+    QPushButton *destructiveButton3 = new QPushButton("Destructive Action 3", tab);
+    destructiveButton3->setObjectName("destructiveButton3");
+    
+    contentLayout->addWidget(descriptionLabel);
+    contentLayout->addWidget(destructiveButton);
+    contentLayout->addWidget(destructiveButton2);
+    contentLayout->addWidget(destructiveButton3);
+    contentLayout->addStretch();
+    
+    layout->addWidget(contentCard);
+    layout->addStretch();
+}
+
+void MainWindow::buildActionListTab(QWidget *page, IosStyle::Variant variant)
+{
+    static const char *const CardNames[] = { "primaryCard", "secondaryCard", "destructiveCard" };
+    
+    QVBoxLayout *layout = new QVBoxLayout(page);
+    layout->setSpacing(16);
+    layout->setContentsMargins(20, 20, 20, 20);
+    
+    QFrame *card = new QFrame(page);
+    card->setObjectName(CardNames[variant]);
+    QVBoxLayout *cardLayout = new QVBoxLayout(card);
+    
+    QLineEdit *filter = new QLineEdit(card);
+    filter->setObjectName("actionFilter");
+    filter->setPlaceholderText("Search actions");
+    filter->setClearButtonEnabled(true);
+    cardLayout->addWidget(filter);
+    
+    ActionFilterModel *proxy = new ActionFilterModel(page);
+    proxy->setSourceModel(m_actionModel);
+    proxy->setVariant(variant);
+    
+    // Rows are painted by the delegate, so the cost does not grow with the
+    // number of actions the way one QPushButton per action does
+    QListView *list = new QListView(card);
+    list->setObjectName("actionList");
+    list->setModel(proxy);
+    list->setItemDelegate(new ActionDelegate(list));
+    list->setUniformItemSizes(true);
+    list->setSelectionMode(QAbstractItemView::NoSelection);
+    list->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+    list->setFrameShape(QFrame::NoFrame);
+    list->setMouseTracking(true);
+    list->viewport()->setAttribute(Qt::WA_Hover);
+    cardLayout->addWidget(list);
+    
+    layout->addWidget(card);
+    
+    connect(filter, &QLineEdit::textChanged, proxy, &ActionFilterModel::setFilterText);
+    connect(list, &QListView::clicked, this, [this](const QModelIndex &index) {
+        const QString id = index.data(ActionListModel::IdRole).toString();
+        MetricsRegistry::counter("qttwobuttons_button_clicks_total", "Clicks per action button", { { "button", id } })
+            ->increment();
+        triggerAction(id);
+    });
+}
+
+void MainWindow::loadStylesheet()
+{
+    StartupTraceScope trace("loadStylesheet");
+    
+    QStringList searchPaths = {
+        "styles.qss",                                    // Current directory
+        QDir::currentPath() + "/styles.qss",            // Current working directory
+        QCoreApplication::applicationDirPath() + "/styles.qss",  // Executable directory
+        QCoreApplication::applicationDirPath() + "/bin/styles.qss", // Build output directory
+        "../styles.qss",                                // Parent directory
+        "../../styles.qss"                              // Grandparent directory
+    };
+    
+    bool stylesheetLoaded = false;
+    
+    for (const QString &path : searchPaths) {
+        QFile file(path);
+        if (file.open(QFile::ReadOnly | QFile::Text)) {
+            QTextStream stream(&file);
+            QString stylesheet = stream.readAll();
+            applyStylesheet(stylesheet);
+            file.close();
+            m_stylesheetPath = QFileInfo(path).absoluteFilePath();
+            qCDebug(lcStyle) << "Stylesheet loaded successfully from:" << path;
+            stylesheetLoaded = true;
+            break;
+        } else {
+            qCDebug(lcStyle) << "Could not open stylesheet from:" << path << "-" << file.errorString();
+        }
+    }
+    
+    if (!stylesheetLoaded) {
+        qCWarning(lcStyle) << "Could not load styles.qss from any location. Using fallback styles.";
+        applyFallbackStylesheet();
+    }
+}
+
+void MainWindow::loadCompiledStylesheet()
+{
+    StartupTraceScope trace("loadCompiledStylesheet");
+    
+    QFile file(":/styles.qss");
+    if (file.open(QFile::ReadOnly | QFile::Text)) {
+        applyStylesheet(QString::fromUtf8(file.readAll()));
+    } else {
+        qCWarning(lcStyle) << "Could not open embedded stylesheet -" << file.errorString();
+        applyFallbackStylesheet();
+    }
+}
+
+void MainWindow::applyFallbackStylesheet()
+{
+    // Apply minimal fallback styles
+    applyStylesheet(R"(
+        /* @scope card */
+        QPushButton {
+            background-color: #007aff;
+            border: none;
+            border-radius: 12px;
+            color: white;
+            padding: 16px 24px;
+            margin: 8px;
+        }
+        QPushButton:hover {
+            background-color: #0056cc;
+        }
+    )");
+}
+
+void MainWindow::applyWindowPalette()
+{
+    // Window background, text color and base font size are set through the
+    // palette rather than a universal QWidget rule, so widgets outside the
+    // styled subtrees never go through the style sheet engine
+    QPalette windowPalette = palette();
+    windowPalette.setColor(QPalette::Window, QColor(0xf2, 0xf2, 0xf7));
+    windowPalette.setColor(QPalette::WindowText, QColor(0x1d, 0x1d, 0x1f));
+    windowPalette.setColor(QPalette::Text, QColor(0x1d, 0x1d, 0x1f));
+    setPalette(windowPalette);
+    setAutoFillBackground(true);
+    
+    QFont windowFont = font();
+    windowFont.setPixelSize(16);
+    setFont(windowFont);
+}
+
+void MainWindow::applyStylesheet(const QString &styleSheet)
+{
+    // Font family lists are resolved to one installed family up front, unless
+    // that would mean waiting for the font loader in the middle of the build;
+    // nothing measures text before resolveFonts() then
+    if (FontLoader::isLoading()) {
+        m_unresolvedStyleSheet = styleSheet;
+        m_styleSheets = StyleSheetCache::split(styleSheet);
+    } else {
+        m_unresolvedStyleSheet.clear();
+        m_styleSheets = StyleSheetCache::split(FontLoader::resolveStyleSheet(styleSheet));
+    }
+    
+    for (const QString &scope : { StyleSheetCache::UnscopedName, QStringLiteral("header"),
+                                  QStringLiteral("dialog"), QStringLiteral("tabs"), QStringLiteral("card") }) {
+        applyScope(scope);
+    }
+}
+
+void MainWindow::applyScope(const QString &scope)
+{
+    const QString sheet = m_styleSheets.value(scope);
+    if (scope == StyleSheetCache::UnscopedName) {
+        // Rules outside any "@scope" section still apply to the whole window
+        setStyleSheet(sheet);
+    } else if (scope == "header") {
+        if (QWidget *headerCard = findChild<QWidget*>("headerCard")) {
+            headerCard->setStyleSheet(sheet);
+        }
+    } else if (scope == "dialog") {
+        m_dialogs->setStyleSheet(sheet);
+    } else if (scope == "tabs" && m_tabWidget) {
+        m_tabWidget->setStyleSheet(sheet);
+    } else if (scope == "card" && m_tabWidget) {
+        for (int i = 0; i < m_tabBuilt.size(); ++i) {
+            if (m_tabBuilt.at(i)) {
+                m_tabWidget->widget(i)->setStyleSheet(sheet);
+            }
+        }
+    }
+}
+
+void MainWindow::resolveFonts()
+{
+    if (m_unresolvedStyleSheet.isEmpty()) {
+        return;
+    }
+    
+    // Only the scopes with a font-family list change, and each setStyleSheet()
+    // repolishes its whole subtree, so the others keep the sheet they have
+    const StyleSheetCache::ScopedSheets unresolved = m_styleSheets;
+    m_styleSheets = StyleSheetCache::split(FontLoader::resolveStyleSheet(m_unresolvedStyleSheet));
+    m_unresolvedStyleSheet.clear();
+    
+    QStringList reapplied;
+    for (auto it = m_styleSheets.cbegin(); it != m_styleSheets.cend(); ++it) {
+        if (it.value() != unresolved.value(it.key())) {
+            applyScope(it.key());
+            reapplied << it.key();
+        }
+    }
+    qCDebug(lcStyle) << "Font families resolved in scopes:" << reapplied;
+}
+
+void MainWindow::connectTabActions(QWidget *page)
+{
+    StartupTraceScope trace("connectSignals");
+    
+    const QList<QPushButton*> buttons = page->findChildren<QPushButton*>();
+    for (QPushButton *button : buttons) {
+        const QString id = button->objectName();
+        if (!m_actions.contains(id)) {
+            qCWarning(lcActions) << "No action registered for button:" << id;
+            continue;
+        }
+        Counter *clicks = MetricsRegistry::counter("qttwobuttons_button_clicks_total", "Clicks per action button",
+                                                   { { "button", id } });
+        connect(button, &QPushButton::clicked, this, [this, id, clicks]() {
+            clicks->increment();
+            triggerAction(id);
+        });
+        // A page built (or rebuilt) while its action runs shows the run
+        updateActionButton(id);
+        qCDebug(lcActions) << "Button" << id << "connected to its action";
+    }
+}
+
+void MainWindow::triggerAction(const QString &id)
+{
+    // A second click on a running action cancels it
+    auto running = m_runningActions.constFind(id);
+    if (running != m_runningActions.cend()) {
+        qCInfo(lcActions) << "Cancelling action" << id;
+        m_executor->cancel(running->runId);
+        return;
+    }
+    
+    const ActionDefinition action = m_actions.action(id);
+    if (!action.hasConfirmation) {
+        runAction(action);
+        return;
+    }
+    
+    m_dialogs->show(action.confirmation, [this, id](QMessageBox::StandardButton result) {
+        if (result == QMessageBox::Yes) {
+            runAction(m_actions.action(id));
+        }
+    });
+}
+
+void MainWindow::runAction(const ActionDefinition &action)
+{
+    RunningAction running;
+    running.runId = m_executor->run(action.id, m_actions.handler(action.handler), action.params);
+    m_runningActions.insert(action.id, running);
+    
+    updateActionButton(action.id);
+    if (m_actionModel) {
+        m_actionModel->setRunning(action.id, true);
+    }
+}
+
+void MainWindow::updateActionButton(const QString &id)
+{
+    QPushButton *button = findChild<QPushButton*>(id);
+    if (!button) {
+        return;
+    }
+    
+    // The text from the .ui file, restored when the run ends
+    if (!button->property("idleText").isValid()) {
+        button->setProperty("idleText", button->text());
+    }
+    auto running = m_runningActions.constFind(id);
+    button->setText(running == m_runningActions.cend() ? button->property("idleText").toString()
+                                                       : QString("Cancel (%1%)").arg(running->percent));
+}
+
+void MainWindow::onActionFinished(int runId, const QString &actionId, ActionExecutor::Status status,
+                                  const QVariant &result, const QString &error)
+{
+    Q_UNUSED(runId);
+    Q_UNUSED(result);
+    
+    m_runningActions.remove(actionId);
+    updateActionButton(actionId);
+    if (m_actionModel) {
+        m_actionModel->setRunning(actionId, false);
+    }
+    
+    if (status == ActionExecutor::Cancelled) {
+        qCInfo(lcActions) << "Action" << actionId << "cancelled";
+    } else if (status == ActionExecutor::Completed) {
+        m_dialogs->show(m_actions.action(actionId).completion);
+    } else if (status == ActionExecutor::Failed) {
+        qCWarning(lcActions) << "Action" << actionId << "failed:" << error;
+        
+        DialogRequest request;
+        request.title = "Action Failed";
+        request.text = error;
+        request.icon = QMessageBox::Critical;
+        request.buttons = QMessageBox::Ok;
+        m_dialogs->show(request);
+    }
+}
+
+void MainWindow::setupHotReload()
+{
+    m_hotReloader = new HotReloader(this);
+    connect(m_hotReloader, &HotReloader::fileChanged, this, &MainWindow::onWatchedFileChanged);
+    
+    if (!m_stylesheetPath.isEmpty()) {
+        m_hotReloader->watch(m_stylesheetPath);
+    }
+    m_hotReloader->watch(m_uiDirectory.filePath("mainwindow.ui"));
+    for (int i = 0; i < m_tabWidget->count(); ++i) {
+        m_hotReloader->watch(m_uiDirectory.filePath(m_tabWidget->widget(i)->objectName().toLower() + ".ui"));
+    }
+}
+
+void MainWindow::onWatchedFileChanged(const QString &path)
+{
+    QElapsedTimer timer;
+    timer.start();
+    
+    const QString fileName = QFileInfo(path).fileName();
+    if (path == m_stylesheetPath) {
+        reloadStylesheet();
+    } else if (fileName == "mainwindow.ui") {
+        reloadHeader();
+    } else {
+        // Tab forms are named after their page: primaryTab -> primarytab.ui
+        for (int i = 0; i < m_tabWidget->count(); ++i) {
+            if (m_tabWidget->widget(i)->objectName().toLower() + ".ui" == fileName) {
+                rebuildTab(i);
+            }
+        }
+    }
+    
+    qCInfo(lcUi) << "Reloaded" << fileName << "in" << timer.nsecsElapsed() / 1e6 << "ms";
+}
+
+void MainWindow::reloadStylesheet()
+{
+    QFile file(m_stylesheetPath);
+    if (!file.open(QFile::ReadOnly | QFile::Text)) {
+        qCWarning(lcStyle) << "Could not reload stylesheet from:" << m_stylesheetPath << "-" << file.errorString();
+        return;
+    }
+    const StyleSheetCache::ScopedSheets sheets =
+        StyleSheetCache::split(FontLoader::resolveStyleSheet(QString::fromUtf8(file.readAll())));
+    
+    // Stored before anything is reapplied: pages that are not built yet take
+    // their sheet from m_styleSheets in ensureTabBuilt(), so they get the new
+    // one when they are built, and so does a page rebuilt by rebuildTab().
+    // resolveFonts() must not put the sheet loaded at startup back.
+    const StyleSheetCache::ScopedSheets previous = m_styleSheets;
+    m_styleSheets = sheets;
+    m_unresolvedStyleSheet.clear();
+    
+    QStringList scopes = sheets.keys() + previous.keys();
+    scopes.removeDuplicates();
+    
+    // Only the subtrees whose scope changed get their sheet set again; tab
+    // pages only when one of their widgets matches a changed selector
+    QStringList changedSelectors;
+    QStringList reapplied;
+    for (const QString &scope : scopes) {
+        const QString before = previous.value(scope);
+        const QString after = sheets.value(scope);
+        if (before == after) {
+            continue;
+        }
+        const QStringList selectors = StyleSheetCache::changedSelectors(before, after);
+        changedSelectors += selectors;
+        
+        if (scope == "card") {
+            for (int i = 0; i < m_tabBuilt.size(); ++i) {
+                if (!m_tabBuilt.at(i)) {
+                    continue;
+                }
+                QWidget *page = m_tabWidget->widget(i);
+                QList<QWidget*> widgets = page->findChildren<QWidget*>();
+                widgets.prepend(page);
+                const bool affected = std::any_of(widgets.cbegin(), widgets.cend(), [&selectors](QWidget *widget) {
+                    return std::any_of(selectors.cbegin(), selectors.cend(), [widget](const QString &selector) {
+                        return StyleSheetCache::selectorMatches(selector, widget);
+                    });
+                });
+                if (affected) {
+                    page->setStyleSheet(after);
+                    reapplied << page->objectName();
+                }
+            }
+        } else if (scope == "header") {
+            if (QWidget *headerCard = findChild<QWidget*>("headerCard")) {
+                headerCard->setStyleSheet(after);
+                reapplied << "headerCard";
+            }
+        } else if (scope == "tabs") {
+            m_tabWidget->setStyleSheet(after);
+            reapplied << "tabWidget";
+        } else if (scope == "dialog") {
+            m_dialogs->setStyleSheet(after);
+            reapplied << "dialogs";
+        } else if (scope == StyleSheetCache::UnscopedName) {
+            setStyleSheet(after);
+            reapplied << "window";
+        }
+    }
+    
+    qCInfo(lcStyle) << "Changed selectors:" << changedSelectors << "- reapplied to:" << reapplied;
+}
+
+void MainWindow::reloadHeader()
+{
+    QFile uiFile(m_uiDirectory.filePath("mainwindow.ui"));
+    if (!uiFile.open(QFile::ReadOnly)) {
+        qCWarning(lcUi) << "Could not open UI file:" << uiFile.fileName() << "-" << uiFile.errorString();
+        return;
+    }
+    QUiLoader loader;
+    QScopedPointer<QWidget> form(loader.load(&uiFile));
+    if (!form) {
+        qCWarning(lcUi) << "Failed to load UI from:" << uiFile.fileName() << "- loader failed";
+        return;
+    }
+    
+    // The tab widget and its pages stay, so the current tab and each tab's
+    // state survive; only the header is swapped and the tab titles updated
+    QWidget *oldHeader = findChild<QWidget*>("headerCard");
+    QWidget *newHeader = form->findChild<QWidget*>("headerCard");
+    if (oldHeader && newHeader && oldHeader->parentWidget()->layout()) {
+        oldHeader->parentWidget()->layout()->replaceWidget(oldHeader, newHeader);
+        delete oldHeader;
+        newHeader->setStyleSheet(m_styleSheets.value("header"));
+    }
+    
+    if (QTabWidget *newTabs = form->findChild<QTabWidget*>("tabWidget")) {
+        for (int i = 0; i < newTabs->count(); ++i) {
+            const QString name = newTabs->widget(i)->objectName();
+            for (int j = 0; j < m_tabWidget->count(); ++j) {
+                if (m_tabWidget->widget(j)->objectName() == name) {
+                    m_tabWidget->setTabText(j, newTabs->tabText(i));
+                }
+            }
+        }
+    }
+}
+
+void MainWindow::rebuildTab(int index)
+{
+    // Not built yet: it will be loaded from the new file when first shown.
+    // Action list tabs are not built from .ui files, so their filter text and
+    // scroll position are never reset here.
+    if (!m_tabBuilt.value(index) || m_actionModel) {
+        return;
+    }
+    
+    // The page itself stays, keeping its place, title and the current index.
+    // Its widgets are thrown away with any state not kept elsewhere; running
+    // actions are, in m_runningActions.
+    QWidget *page = m_tabWidget->widget(index);
+    qDeleteAll(page->findChildren<QWidget*>(QString(), Qt::FindDirectChildrenOnly));
+    delete page->layout();
+    
+    // Built from the new file with the current card sheet; connectTabActions()
+    // shows the progress of running actions on the new buttons, and a click on
+    // one still cancels its run
+    m_tabBuilt[index] = false;
+    ensureTabBuilt(index);
+}
+
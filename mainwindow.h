@@ -0,0 +1,132 @@
+#ifndef MAINWINDOW_H
+#define MAINWINDOW_H
+
+#include <QDir>
+#include <QHash>
+#include <QTimer>
+#include <QVector>
+#include <QWidget>
+
+#include "ui_mainwindow.h"
+#include "stylesheetcache.h"
+#include "dialogservice.h"
+#include "actionregistry.h"
+#include "actionexecutor.h"
+#include "iosstyle.h"
+
+class ActionListModel;
+class HotReloader;
+class QShowEvent;
+class QTabWidget;
+
+struct MainWindowOptions
+{
+    // Load mainwindow.ui and styles.qss from disk instead of the compiled-in copies
+    bool dynamicUI = false;
+    // Build the UI programmatically with createFallbackUI() instead of from any .ui file
+    bool fallbackUI = false;
+    // The application style is IosStyle, so styles.qss is not applied
+    bool nativeStyle = false;
+    // Show each tab's actions in a virtualized list instead of one button per action
+    bool actionList = false;
+    // Action table to load; the production catalog can hold thousands of entries
+    QString actionsPath = QStringLiteral(":/actions.json");
+    // Developer mode: watch styles.qss and the .ui files and apply edits live;
+    // only effective together with dynamicUI
+    bool hotReload = false;
+};
+
+class MainWindow : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit MainWindow(const MainWindowOptions &options = MainWindowOptions(), QWidget *parent = nullptr);
+
+    // Splits styleSheet at its "@scope" markers and applies each part to its subtree
+    void applyStylesheet(const QString &styleSheet);
+
+    // While FontLoader is still registering fonts, applyStylesheet() leaves
+    // font-family lists as they are; this sets the scopes that have one again
+    // with them resolved. Call it after FontLoader::waitForFinished().
+    void resolveFonts();
+
+    DialogService *dialogs() const { return m_dialogs; }
+    const ActionRegistry &actions() const { return m_actions; }
+    // Null when the UI has no tab widget; selecting a tab builds it
+    QTabWidget *tabWidget() const { return m_tabWidget; }
+
+    // Handles --tab=<name> (page name without "Tab", title or index) and
+    // --action=<id>; used for launch arguments and forwarded launches
+    void activate(const QStringList &arguments);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+
+private:
+    void setupCompiledUI();
+    bool loadUI();
+    QWidget *loadTabUI(QWidget *page, const QString &fileName);
+    void ensureTabBuilt(int index);
+    void prebuildNextTab();
+    void prewarmDialogs();
+    template <typename Form>
+    void buildTab(QWidget *page, const QString &fileName, void (MainWindow::*createFallbackTab)(QWidget *));
+    void createFallbackUI();
+    void createPrimaryTab(QWidget *tab);
+    void createSecondaryTab(QWidget *tab);
+    void createDestructiveTab(QWidget *tab);
+    void buildActionListTab(QWidget *page, IosStyle::Variant variant);
+    void loadStylesheet();
+    void loadCompiledStylesheet();
+    void applyFallbackStylesheet();
+    void applyWindowPalette();
+    // Sets the m_styleSheets part for scope on the widgets it applies to
+    void applyScope(const QString &scope);
+    void connectTabActions(QWidget *page);
+    void triggerAction(const QString &id);
+    void runAction(const ActionDefinition &action);
+    void updateActionButton(const QString &id);
+    void setupHotReload();
+    void onWatchedFileChanged(const QString &path);
+    void reloadStylesheet();
+    void reloadHeader();
+    void rebuildTab(int index);
+
+private slots:
+    void onActionFinished(int runId, const QString &actionId, ActionExecutor::Status status,
+                          const QVariant &result, const QString &error);
+
+private:
+    enum class UiSource { Compiled, Dynamic, Fallback };
+
+    DialogService *m_dialogs;
+    ActionExecutor *m_executor;
+    ActionRegistry m_actions;
+    struct RunningAction
+    {
+        int runId = 0;
+        int percent = 0;
+    };
+    // By action id; while running, the button shows the progress and a click
+    // on it (or on the list row) cancels the run
+    QHash<QString, RunningAction> m_runningActions;
+    // Only set in action list mode
+    ActionListModel *m_actionModel = nullptr;
+
+    Ui::MainWindow m_ui;
+
+    UiSource m_uiSource = UiSource::Compiled;
+    QDir m_uiDirectory;
+    QTabWidget *m_tabWidget = nullptr;
+    QVector<bool> m_tabBuilt;
+    QTimer m_prebuildTimer;
+    StyleSheetCache::ScopedSheets m_styleSheets;
+    // Applied before the fonts were registered, so font families are unresolved
+    QString m_unresolvedStyleSheet;
+    // Where loadStylesheet() found styles.qss, for hot reload
+    QString m_stylesheetPath;
+    HotReloader *m_hotReloader = nullptr;
+};
+
+#endif // MAINWINDOW_H
@@ -0,0 +1,172 @@
+#include "memoryreport.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QObject>
+#include <QTextStream>
+#include <QWidget>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include "logcategories.h"
+
+bool MemoryReport::s_enabled = false;
+QString MemoryReport::s_outputPath;
+QHash<const QObject *, qint64> MemoryReport::s_attributed;
+MemoryScope *MemoryScope::s_current = nullptr;
+
+namespace {
+
+// Containers with these names are Qt internals (e.g. the tab widget's stack)
+// and are looked through rather than listed
+const QLatin1String InternalPrefix("qt_");
+
+QString formatKiB(qint64 bytes)
+{
+    return QString::number(bytes / 1024.0, 'f', 1);
+}
+
+bool isContainer(const QObject *object)
+{
+    for (const QObject *child : object->children()) {
+        if (child->isWidgetType()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+void MemoryReport::enable(const QString &outputPath)
+{
+    s_enabled = true;
+    s_outputPath = outputPath;
+    if (!s_outputPath.isEmpty()) {
+        QFile file(s_outputPath);
+        if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+            qCWarning(lcUi) << "Cannot write memory report to" << s_outputPath << "-" << file.errorString();
+        }
+    }
+}
+
+qint64 MemoryReport::heapInUse()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    const struct mallinfo2 info = mallinfo2();
+    return qint64(info.uordblks + info.hblkhd);
+#elif defined(__GLIBC__)
+    // The int fields of mallinfo() wrap above 2 GiB
+    const struct mallinfo info = mallinfo();
+    return qint64(unsigned(info.uordblks)) + qint64(unsigned(info.hblkhd));
+#else
+    return -1;
+#endif
+}
+
+void MemoryReport::attribute(const QObject *object, qint64 bytes)
+{
+    s_attributed[object] += bytes;
+}
+
+MemoryReport::Totals MemoryReport::totals(const QObject *root)
+{
+    Totals totals;
+    totals.objects = 1;
+    if (root->isWidgetType()) {
+        ++totals.widgets;
+        if (!static_cast<const QWidget *>(root)->styleSheet().isEmpty()) {
+            ++totals.styleSheets;
+        }
+    }
+    auto it = s_attributed.constFind(root);
+    if (it != s_attributed.constEnd()) {
+        totals.heapBytes = it.value();
+        totals.measured = true;
+    }
+
+    for (const QObject *child : root->children()) {
+        const Totals childTotals = MemoryReport::totals(child);
+        totals.objects += childTotals.objects;
+        totals.widgets += childTotals.widgets;
+        totals.styleSheets += childTotals.styleSheets;
+        totals.heapBytes += childTotals.heapBytes;
+        totals.measured = totals.measured || childTotals.measured;
+    }
+    return totals;
+}
+
+void MemoryReport::writeSubtree(QTextStream &out, const QObject *object, int depth)
+{
+    const Totals subtree = totals(object);
+    const QString name = (object->objectName().isEmpty() ? QStringLiteral("<unnamed>") : object->objectName())
+                         + " (" + object->metaObject()->className() + ")";
+    out << QString(depth * 2, QLatin1Char(' ')) << name.leftJustified(44 - depth * 2)
+        << QString::number(subtree.objects).rightJustified(9) << QString::number(subtree.widgets).rightJustified(8)
+        << QString::number(subtree.styleSheets).rightJustified(13)
+        << (subtree.measured ? formatKiB(subtree.heapBytes) : QStringLiteral("-")).rightJustified(10) << "\n";
+
+    // Named containers get their own line; Qt internals are looked through
+    QObjectList pending = object->children();
+    while (!pending.isEmpty()) {
+        const QObject *child = pending.takeFirst();
+        if (!child->isWidgetType() || !isContainer(child)) {
+            continue;
+        }
+        if (child->objectName().isEmpty() || child->objectName().startsWith(InternalPrefix)) {
+            pending = child->children() + pending;
+            continue;
+        }
+        writeSubtree(out, child, depth + 1);
+    }
+}
+
+void MemoryReport::write(const QObject *root, const QString &when)
+{
+    if (!s_enabled || !root) {
+        return;
+    }
+
+    QFile file;
+    if (s_outputPath.isEmpty()) {
+        file.open(stdout, QFile::WriteOnly);
+    } else {
+        file.setFileName(s_outputPath);
+        if (!file.open(QFile::WriteOnly | QFile::Append)) {
+            return;
+        }
+    }
+    QTextStream out(&file);
+
+    const qint64 heap = heapInUse();
+    out << "== " << when << ": heap in use " << (heap >= 0 ? formatKiB(heap) + " KiB" : QStringLiteral("n/a"))
+        << " ==\n";
+    out << QStringLiteral("subtree").leftJustified(44) << "  objects widgets  stylesheets  heap KiB\n";
+    writeSubtree(out, root, 0);
+    out << "\n";
+}
+
+MemoryScope::MemoryScope(const QObject *object)
+    : m_object(object)
+    , m_start(MemoryReport::isEnabled() ? MemoryReport::heapInUse() : -1)
+    , m_outer(s_current)
+{
+    if (m_start >= 0) {
+        s_current = this;
+    }
+}
+
+MemoryScope::~MemoryScope()
+{
+    if (m_start < 0) {
+        return;
+    }
+    const qint64 growth = MemoryReport::heapInUse() - m_start;
+    MemoryReport::attribute(m_object, growth - m_inner);
+    s_current = m_outer;
+    if (m_outer) {
+        m_outer->m_inner += growth;
+    }
+}
@@ -0,0 +1,73 @@
+#ifndef MEMORYREPORT_H
+#define MEMORYREPORT_H
+
+#include <QHash>
+#include <QString>
+
+class QObject;
+class QTextStream;
+
+// Object-tree memory accounting for --memory-report. write() walks the
+// window's QObject tree and lists each named container subtree with its
+// object and widget counts, how many widgets carry their own style sheet,
+// and the heap growth measured while the subtree was built.
+//
+// Heap numbers come from the allocator (mallinfo2 with glibc) as the
+// difference in bytes in use around a build step, and are attributed to the
+// object that step built (see MemoryScope). Allocations by other threads in
+// the meantime are included, so they are estimates; elsewhere they are not
+// available. When the report is disabled nothing is measured.
+class MemoryReport
+{
+public:
+    // outputPath empty writes to stdout
+    static void enable(const QString &outputPath);
+    static bool isEnabled() { return s_enabled; }
+
+    // Bytes the allocator has handed out and not got back, or -1
+    static qint64 heapInUse();
+
+    static void attribute(const QObject *object, qint64 bytes);
+
+    // Appends one report section, titled with when
+    static void write(const QObject *root, const QString &when);
+
+private:
+    struct Totals
+    {
+        int objects = 0;
+        int widgets = 0;
+        int styleSheets = 0;
+        qint64 heapBytes = 0;
+        bool measured = false;
+    };
+
+    static Totals totals(const QObject *root);
+    static void writeSubtree(QTextStream &out, const QObject *object, int depth);
+
+    static bool s_enabled;
+    static QString s_outputPath;
+    static QHash<const QObject *, qint64> s_attributed;
+};
+
+// Attributes the heap growth during its lifetime to object. Scopes nest on
+// the GUI thread; growth inside an inner scope goes to the inner object only.
+class MemoryScope
+{
+public:
+    explicit MemoryScope(const QObject *object);
+    ~MemoryScope();
+
+    MemoryScope(const MemoryScope &) = delete;
+    MemoryScope &operator=(const MemoryScope &) = delete;
+
+private:
+    const QObject *m_object;
+    qint64 m_start;
+    qint64 m_inner = 0;
+    MemoryScope *m_outer;
+
+    static MemoryScope *s_current;
+};
+
+#endif // MEMORYREPORT_H
@@ -0,0 +1,208 @@
+#include "metrics.h"
+
+#include <QCoreApplication>
+#include <QEvent>
+#include <QHash>
+#include <QWidget>
+
+#include <cstring>
+
+const double Histogram::UpperBounds[Histogram::BucketCount - 1] = {
+    0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10
+};
+
+QMutex MetricsRegistry::s_mutex;
+std::vector<MetricsRegistry::Family> MetricsRegistry::s_families;
+
+namespace {
+
+const char *const TypeNames[] = { "counter", "gauge", "histogram" };
+
+QByteArray escapeLabelValue(const QString &value)
+{
+    QByteArray escaped;
+    const QByteArray utf8 = value.toUtf8();
+    escaped.reserve(utf8.size());
+    for (const char c : utf8) {
+        if (c == '\\' || c == '"') {
+            escaped += '\\';
+            escaped += c;
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+QByteArray formatLabels(const MetricsRegistry::Labels &labels)
+{
+    if (labels.isEmpty()) {
+        return QByteArray();
+    }
+    QByteArray formatted = "{";
+    for (const auto &label : labels) {
+        if (formatted.size() > 1) {
+            formatted += ',';
+        }
+        formatted += label.first + "=\"" + escapeLabelValue(label.second) + '"';
+    }
+    return formatted + '}';
+}
+
+// Adds le="bound" to an already formatted label set
+QByteArray withBucketLabel(const QByteArray &labels, const QByteArray &bound)
+{
+    const QByteArray le = "le=\"" + bound + '"';
+    return labels.isEmpty() ? '{' + le + '}' : labels.left(labels.size() - 1) + ',' + le + '}';
+}
+
+QByteArray formatValue(double value)
+{
+    return QByteArray::number(value, 'g', 12);
+}
+
+class PaintCounter : public QObject
+{
+public:
+    using QObject::QObject;
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override
+    {
+        if (event->type() == QEvent::Paint && watched->isWidgetType()) {
+            const QWidget *window = static_cast<QWidget *>(watched)->window();
+            const QString name = window->objectName().isEmpty() ? QString::fromLatin1(window->metaObject()->className())
+                                                                 : window->objectName();
+            Counter *&counter = m_counters[name];
+            if (!counter) {
+                counter = MetricsRegistry::counter("qttwobuttons_paint_events_total",
+                                                   "Paint events delivered to widgets, by top-level window",
+                                                   { { "window", name } });
+            }
+            counter->increment();
+        }
+        return QObject::eventFilter(watched, event);
+    }
+
+private:
+    QHash<QString, Counter *> m_counters;
+};
+
+} // namespace
+
+void Histogram::observe(qint64 nanoseconds)
+{
+    nanoseconds = qMax<qint64>(nanoseconds, 0);
+    const double seconds = nanoseconds / 1e9;
+    int index = 0;
+    while (index < BucketCount - 1 && seconds > UpperBounds[index]) {
+        ++index;
+    }
+    m_buckets[index].fetch_add(1, std::memory_order_relaxed);
+    m_sumNs.fetch_add(quint64(nanoseconds), std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+Counter *MetricsRegistry::counter(const char *name, const char *help, const Labels &labels)
+{
+    return series(name, help, Type::Counter, labels)->counter.get();
+}
+
+Gauge *MetricsRegistry::gauge(const char *name, const char *help, const Labels &labels)
+{
+    return series(name, help, Type::Gauge, labels)->gauge.get();
+}
+
+Histogram *MetricsRegistry::histogram(const char *name, const char *help, const Labels &labels)
+{
+    return series(name, help, Type::Histogram, labels)->histogram.get();
+}
+
+MetricsRegistry::Series *MetricsRegistry::series(const char *name, const char *help, Type type, const Labels &labels)
+{
+    const QByteArray formattedLabels = formatLabels(labels);
+
+    QMutexLocker locker(&s_mutex);
+    Family *family = nullptr;
+    for (Family &candidate : s_families) {
+        if (std::strcmp(candidate.name, name) == 0) {
+            family = &candidate;
+            break;
+        }
+    }
+    if (!family) {
+        s_families.push_back({ name, help, type, {} });
+        family = &s_families.back();
+    }
+    Q_ASSERT(family->type == type);
+
+    for (const std::unique_ptr<Series> &existing : family->series) {
+        if (existing->labels == formattedLabels) {
+            return existing.get();
+        }
+    }
+
+    auto created = std::make_unique<Series>();
+    created->labels = formattedLabels;
+    switch (type) {
+    case Type::Counter:
+        created->counter = std::make_unique<Counter>();
+        break;
+    case Type::Gauge:
+        created->gauge = std::make_unique<Gauge>();
+        break;
+    case Type::Histogram:
+        created->histogram = std::make_unique<Histogram>();
+        break;
+    }
+    family->series.push_back(std::move(created));
+    return family->series.back().get();
+}
+
+QByteArray MetricsRegistry::exposition()
+{
+    QByteArray text;
+    QMutexLocker locker(&s_mutex);
+    for (const Family &family : s_families) {
+        text += QByteArray("# HELP ") + family.name + ' ' + family.help + '\n';
+        text += QByteArray("# TYPE ") + family.name + ' ' + TypeNames[int(family.type)] + '\n';
+        for (const std::unique_ptr<Series> &series : family.series) {
+            switch (family.type) {
+            case Type::Counter:
+                text += family.name + series->labels + ' ' + QByteArray::number(series->counter->value()) + '\n';
+                break;
+            case Type::Gauge:
+                text += family.name + series->labels + ' ' + formatValue(series->gauge->value()) + '\n';
+                break;
+            case Type::Histogram: {
+                const Histogram &histogram = *series->histogram;
+                quint64 cumulative = 0;
+                for (int i = 0; i < Histogram::BucketCount; ++i) {
+                    cumulative += histogram.bucket(i);
+                    const QByteArray bound = i < Histogram::BucketCount - 1 ? formatValue(Histogram::UpperBounds[i])
+                                                                             : QByteArray("+Inf");
+                    text += family.name + QByteArray("_bucket") + withBucketLabel(series->labels, bound) + ' '
+                            + QByteArray::number(cumulative) + '\n';
+                }
+                // _count is taken from the buckets, so it matches +Inf even
+                // while observe() runs on another thread
+                text += family.name + QByteArray("_sum") + series->labels + ' ' + formatValue(histogram.sum()) + '\n';
+                text += family.name + QByteArray("_count") + series->labels + ' ' + QByteArray::number(cumulative) + '\n';
+                break;
+            }
+            }
+        }
+    }
+    return text;
+}
+
+void MetricsRegistry::countPaints()
+{
+    static PaintCounter *counter = nullptr;
+    if (!counter) {
+        counter = new PaintCounter(QCoreApplication::instance());
+        QCoreApplication::instance()->installEventFilter(counter);
+    }
+}
@@ -0,0 +1,99 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <QByteArray>
+#include <QList>
+#include <QMutex>
+#include <QPair>
+#include <QString>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class Counter
+{
+public:
+    void increment(quint64 amount = 1) { m_value.fetch_add(amount, std::memory_order_relaxed); }
+    quint64 value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<quint64> m_value{0};
+};
+
+class Gauge
+{
+public:
+    void set(double value) { m_value.store(value, std::memory_order_relaxed); }
+    double value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> m_value{0};
+};
+
+// Latency histogram with fixed Prometheus-style buckets from 1 ms to 10 s
+class Histogram
+{
+public:
+    static constexpr int BucketCount = 14;
+    // Upper bounds in seconds; the last bucket is +Inf
+    static const double UpperBounds[BucketCount - 1];
+
+    void observe(qint64 nanoseconds);
+
+    quint64 bucket(int index) const { return m_buckets[index].load(std::memory_order_relaxed); }
+    quint64 count() const { return m_count.load(std::memory_order_relaxed); }
+    double sum() const { return m_sumNs.load(std::memory_order_relaxed) / 1e9; }
+
+private:
+    std::atomic<quint64> m_buckets[BucketCount] = {};
+    std::atomic<quint64> m_count{0};
+    std::atomic<quint64> m_sumNs{0};
+};
+
+// Process-wide registry of counters, gauges and histograms. Looking a series
+// up takes a mutex, so hot paths keep the returned pointer, which stays valid
+// for the lifetime of the process; updating it is a relaxed atomic operation.
+// exposition() may be called from any thread.
+class MetricsRegistry
+{
+public:
+    using Labels = QList<QPair<QByteArray, QString>>;
+
+    // name and help must point to string literals
+    static Counter *counter(const char *name, const char *help, const Labels &labels = Labels());
+    static Gauge *gauge(const char *name, const char *help, const Labels &labels = Labels());
+    static Histogram *histogram(const char *name, const char *help, const Labels &labels = Labels());
+
+    // Prometheus text exposition format, version 0.0.4
+    static QByteArray exposition();
+
+    // Counts paint events per window in qttwobuttons_paint_events_total
+    static void countPaints();
+
+private:
+    enum class Type { Counter, Gauge, Histogram };
+
+    struct Series
+    {
+        QByteArray labels;
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+    };
+
+    struct Family
+    {
+        const char *name;
+        const char *help;
+        Type type;
+        std::vector<std::unique_ptr<Series>> series;
+    };
+
+    static Series *series(const char *name, const char *help, Type type, const Labels &labels);
+
+    static QMutex s_mutex;
+    static std::vector<Family> s_families;
+};
+
+#endif // METRICS_H
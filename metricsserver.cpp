@@ -0,0 +1,189 @@
+#include "metricsserver.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QHostAddress>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QStandardPaths>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#endif
+
+#include "metrics.h"
+#include "logcategories.h"
+
+namespace {
+
+// Longest request line accepted before the connection is dropped
+const int MaxRequestLine = 4096;
+
+// A connection is closed this long after it was accepted, answered or not
+const int ConnectionTimeoutMs = 5000;
+
+// How long a probe waits for a server on an existing socket to accept
+const int ProbeTimeoutMs = 200;
+
+// Only a socket nobody accepts connections on is left over from a crash;
+// anything else at path (a live server, a regular file) is not ours to remove
+bool isStaleSocket(const QString &path)
+{
+#ifdef Q_OS_UNIX
+    struct stat info;
+    if (::lstat(QFile::encodeName(path).constData(), &info) != 0 || !S_ISSOCK(info.st_mode)) {
+        return false;
+    }
+#endif
+    QLocalSocket probe;
+    probe.connectToServer(path);
+    return !probe.waitForConnected(ProbeTimeoutMs);
+}
+
+QByteArray response(const QByteArray &status, const QByteArray &body)
+{
+    return "HTTP/1.0 " + status + "\r\n"
+           "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+           "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+           "Connection: close\r\n"
+           "\r\n" + body;
+}
+
+} // namespace
+
+MetricsServer::MetricsServer(QObject *parent) : QObject(parent)
+{
+    m_thread.setObjectName("metrics");
+}
+
+MetricsServer::~MetricsServer()
+{
+    stop();
+}
+
+QString MetricsServer::defaultSocketPath()
+{
+    QString directory = QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation);
+    if (directory.isEmpty()) {
+        directory = QDir::tempPath();
+    }
+    return directory + QString("/qttwobuttons-%1.metrics").arg(QCoreApplication::applicationPid());
+}
+
+bool MetricsServer::start(const QString &socketPath, quint16 port)
+{
+    if (m_context) {
+        return true;
+    }
+
+    // Servers and connections are created inside the thread, as children of
+    // m_context, so all their signals are handled there
+    m_thread.start();
+    m_context = new QObject;
+    m_context->moveToThread(&m_thread);
+
+    bool ok = false;
+    QMetaObject::invokeMethod(m_context, [this, socketPath, port, &ok]() {
+        listen(socketPath, port, &ok);
+    }, Qt::BlockingQueuedConnection);
+
+    if (!ok) {
+        stop();
+    }
+    return ok;
+}
+
+void MetricsServer::stop()
+{
+    if (!m_context) {
+        return;
+    }
+    // Deferred deletes are delivered when the thread finishes, which closes
+    // the servers and removes the socket file
+    m_context->deleteLater();
+    m_context = nullptr;
+    m_thread.quit();
+    m_thread.wait();
+}
+
+void MetricsServer::listen(const QString &socketPath, quint16 port, bool *ok)
+{
+    if (!socketPath.isEmpty()) {
+        QLocalServer *server = new QLocalServer(m_context);
+        // A socket left behind by a crashed instance would make listen() fail
+        if (isStaleSocket(socketPath)) {
+            QLocalServer::removeServer(socketPath);
+        }
+        if (server->listen(socketPath)) {
+            connect(server, &QLocalServer::newConnection, m_context, [this, server]() {
+                while (QLocalSocket *socket = server->nextPendingConnection()) {
+                    connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+                    serve(socket);
+                }
+            });
+            qCInfo(lcStartup) << "Metrics served on" << server->fullServerName();
+            *ok = true;
+        } else {
+            qCWarning(lcStartup) << "Cannot serve metrics on" << socketPath << "-" << server->errorString();
+        }
+    }
+
+    if (port != 0) {
+        QTcpServer *server = new QTcpServer(m_context);
+        if (server->listen(QHostAddress::LocalHost, port)) {
+            connect(server, &QTcpServer::newConnection, m_context, [this, server]() {
+                while (QTcpSocket *socket = server->nextPendingConnection()) {
+                    connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+                    serve(socket);
+                }
+            });
+            qCInfo(lcStartup) << "Metrics served on" << QString("http://127.0.0.1:%1/metrics").arg(port);
+            *ok = true;
+        } else {
+            qCWarning(lcStartup) << "Cannot serve metrics on port" << port << "-" << server->errorString();
+        }
+    }
+}
+
+void MetricsServer::serve(QIODevice *socket)
+{
+    // A client that never sends a request (or never reads the response)
+    // does not keep its connection open
+    QTimer *timeout = new QTimer(socket);
+    timeout->setSingleShot(true);
+    connect(timeout, &QTimer::timeout, socket, [socket]() {
+        socket->close();
+    });
+    timeout->start(ConnectionTimeoutMs);
+
+    // Any GET of / or /metrics gets the exposition; only the request line is
+    // looked at, and the connection is closed after one response
+    connect(socket, &QIODevice::readyRead, m_context, [socket]() {
+        if (!socket->canReadLine()) {
+            if (socket->bytesAvailable() > MaxRequestLine) {
+                socket->close();
+            }
+            return;
+        }
+        QObject::disconnect(socket, &QIODevice::readyRead, nullptr, nullptr);
+
+        const QList<QByteArray> request = socket->readLine(MaxRequestLine).trimmed().split(' ');
+        if (request.size() >= 2 && request.at(0) == "GET" && (request.at(1) == "/metrics" || request.at(1) == "/")) {
+            socket->write(response("200 OK", MetricsRegistry::exposition()));
+        } else {
+            socket->write(response("404 Not Found", "Not found\n"));
+        }
+
+        // Both wait for the response to be written before closing
+        if (QLocalSocket *localSocket = qobject_cast<QLocalSocket *>(socket)) {
+            localSocket->disconnectFromServer();
+        } else if (QTcpSocket *tcpSocket = qobject_cast<QTcpSocket *>(socket)) {
+            tcpSocket->disconnectFromHost();
+        }
+    });
+}
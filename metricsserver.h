@@ -0,0 +1,37 @@
+#ifndef METRICSSERVER_H
+#define METRICSSERVER_H
+
+#include <QObject>
+#include <QString>
+#include <QThread>
+
+class QIODevice;
+
+// Serves MetricsRegistry::exposition() over HTTP on a Unix domain socket
+// (--metrics-socket) and/or 127.0.0.1 (--metrics-port). The sockets live on
+// their own thread, so a scrape is answered even while the GUI thread is
+// stalled, which is when the numbers matter most.
+class MetricsServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MetricsServer(QObject *parent = nullptr);
+    ~MetricsServer() override;
+
+    // Default socket path: qttwobuttons-<pid>.metrics in the runtime directory
+    static QString defaultSocketPath();
+
+    // Either may be empty or 0 to skip it; false if nothing could be opened
+    bool start(const QString &socketPath, quint16 port);
+    void stop();
+
+private:
+    void listen(const QString &socketPath, quint16 port, bool *ok);
+    void serve(QIODevice *socket);
+
+    QThread m_thread;
+    QObject *m_context = nullptr;
+};
+
+#endif // METRICSSERVER_H
@@ -0,0 +1,104 @@
+#include "rendercache.h"
+
+#include <QHashFunctions>
+#include <QPaintDevice>
+#include <QPainter>
+#include <QtMath>
+
+namespace {
+
+// Enough for every variant and state of the buttons and cards at two pixel ratios
+const int DefaultBudgetKib = 4096;
+
+} // namespace
+
+QCache<RenderCache::Key, QPixmap> RenderCache::s_cache(DefaultBudgetKib);
+int RenderCache::s_hits = 0;
+int RenderCache::s_misses = 0;
+
+bool operator==(const RenderCache::Key &a, const RenderCache::Key &b)
+{
+    return a.shape == b.shape && a.variant == b.variant && a.state == b.state
+           && a.size == b.size && a.radius == b.radius && a.devicePixelRatio == b.devicePixelRatio;
+}
+
+size_t qHash(const RenderCache::Key &key, size_t seed)
+{
+    return qHashMulti(seed, int(key.shape), key.variant, int(key.state), key.size.width(),
+                      key.size.height(), key.radius, key.devicePixelRatio);
+}
+
+RenderCache::ShapeState RenderCache::stateFor(QStyle::State state)
+{
+    if (!(state & QStyle::State_Enabled)) {
+        return Disabled;
+    }
+    if (state & (QStyle::State_Sunken | QStyle::State_On)) {
+        return Pressed;
+    }
+    if (state & QStyle::State_MouseOver) {
+        return Hover;
+    }
+    return Normal;
+}
+
+void RenderCache::draw(QPainter *painter, const QRectF &rect, Shape shape, int variant,
+                       QStyle::State state, qreal radius, const Renderer &renderer)
+{
+    // A cached bitmap would be resampled under scaling or rotation
+    if (painter->transform().type() > QTransform::TxTranslate || rect.isEmpty()) {
+        renderer(painter, rect);
+        return;
+    }
+
+    const qreal devicePixelRatio = painter->device() ? painter->device()->devicePixelRatio() : 1.0;
+
+    Key key;
+    key.shape = shape;
+    key.variant = variant;
+    key.state = stateFor(state);
+    key.size = QSize(qCeil(rect.width()), qCeil(rect.height()));
+    key.radius = qRound(radius * 100);
+    key.devicePixelRatio = qRound(devicePixelRatio * 100);
+
+    if (const QPixmap *pixmap = s_cache.object(key)) {
+        ++s_hits;
+        painter->drawPixmap(rect.topLeft(), *pixmap);
+        return;
+    }
+    ++s_misses;
+
+    QPixmap pixmap(key.size * devicePixelRatio);
+    pixmap.setDevicePixelRatio(devicePixelRatio);
+    pixmap.fill(Qt::transparent);
+    {
+        QPainter pixmapPainter(&pixmap);
+        renderer(&pixmapPainter, QRectF(QPointF(0, 0), rect.size()));
+    }
+    painter->drawPixmap(rect.topLeft(), pixmap);
+
+    const int costKib = qMax(1, int(qint64(pixmap.width()) * pixmap.height() * pixmap.depth() / 8 / 1024));
+    s_cache.insert(key, new QPixmap(pixmap), costKib);
+}
+
+void RenderCache::setBudget(int kib)
+{
+    s_cache.setMaxCost(kib);
+}
+
+int RenderCache::budget()
+{
+    return int(s_cache.maxCost());
+}
+
+int RenderCache::size()
+{
+    return int(s_cache.totalCost());
+}
+
+void RenderCache::clear()
+{
+    s_cache.clear();
+    s_hits = 0;
+    s_misses = 0;
+}
@@ -0,0 +1,73 @@
+#ifndef RENDERCACHE_H
+#define RENDERCACHE_H
+
+#include <QCache>
+#include <QPixmap>
+#include <QSize>
+#include <QStyle>
+
+#include <functional>
+
+class QPainter;
+
+// Keeps rasterized button and card shapes, keyed by shape, variant, state,
+// size and device pixel ratio, so repaints during hover and press changes
+// blit a pixmap instead of redrawing antialiased rounded rects. Least
+// recently used pixmaps are dropped once the budget is exceeded.
+class RenderCache
+{
+public:
+    enum Shape {
+        Button,
+        Card
+    };
+
+    enum ShapeState {
+        Normal,
+        Hover,
+        Pressed,
+        Disabled
+    };
+
+    struct Key
+    {
+        Shape shape = Button;
+        int variant = 0;
+        ShapeState state = Normal;
+        QSize size;
+        // Radius and device pixel ratio are stored in 1/100ths to hash exactly
+        int radius = 0;
+        int devicePixelRatio = 100;
+    };
+
+    using Renderer = std::function<void(QPainter *painter, const QRectF &rect)>;
+
+    static ShapeState stateFor(QStyle::State state);
+
+    // Draws rect with renderer, through the cache when the painter allows it
+    // (no scaling or rotation); renderer paints into rect in device-independent pixels
+    static void draw(QPainter *painter, const QRectF &rect, Shape shape, int variant,
+                     QStyle::State state, qreal radius, const Renderer &renderer);
+
+    // Budget in KiB; shrinking it evicts immediately
+    static void setBudget(int kib);
+    static int budget();
+    // Current size in KiB
+    static int size();
+
+    static int hits() { return s_hits; }
+    static int misses() { return s_misses; }
+    // Also releases the pixmaps; call it before QApplication is destroyed,
+    // as Qt does not support pixmaps that outlive it
+    static void clear();
+
+private:
+    static QCache<Key, QPixmap> s_cache;
+    static int s_hits;
+    static int s_misses;
+};
+
+bool operator==(const RenderCache::Key &a, const RenderCache::Key &b);
+size_t qHash(const RenderCache::Key &key, size_t seed = 0);
+
+#endif // RENDERCACHE_H
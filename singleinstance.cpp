@@ -0,0 +1,143 @@
+#include "singleinstance.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QLockFile>
+#include <QStandardPaths>
+
+#include "logcategories.h"
+
+namespace {
+
+// Written back once the arguments have been read
+const char Acknowledge = 'A';
+
+// How long listen() waits for an existing server to accept a connection
+const int ProbeTimeoutMs = 200;
+
+} // namespace
+
+QLockFile *SingleInstance::s_startupLock = nullptr;
+
+SingleInstance::SingleInstance(QObject *parent)
+    : QObject(parent)
+    , m_server(new QLocalServer(this))
+{
+    // Other users on the machine must not be able to connect to us
+    m_server->setSocketOptions(QLocalServer::UserAccessOption);
+    connect(m_server, &QLocalServer::newConnection, this, &SingleInstance::onNewConnection);
+}
+
+QString SingleInstance::runtimeDirectory()
+{
+    const QString directory = QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation);
+    return directory.isEmpty() ? QDir::tempPath() : directory;
+}
+
+QString SingleInstance::serverName()
+{
+#ifdef Q_OS_WIN
+    // Named pipes have no directory; UserAccessOption restricts the pipe to us
+    QByteArray user = qgetenv("USERNAME");
+    const QByteArray hash = QCryptographicHash::hash(user, QCryptographicHash::Sha1).toHex().left(12);
+    return QStringLiteral("QtTwoButtonsApp-") + QString::fromLatin1(hash);
+#else
+    // A full path in the user's runtime directory (mode 0700), where another
+    // user cannot create the socket first
+    return QDir(runtimeDirectory()).filePath(QStringLiteral("QtTwoButtonsApp.socket"));
+#endif
+}
+
+bool SingleInstance::lockStartup(int timeoutMs)
+{
+    if (!s_startupLock) {
+        s_startupLock = new QLockFile(QDir(runtimeDirectory()).filePath(QStringLiteral("QtTwoButtonsApp.lock")));
+    }
+    if (s_startupLock->isLocked()) {
+        return true;
+    }
+    if (!s_startupLock->tryLock(timeoutMs)) {
+        qCWarning(lcStartup) << "Single instance: another launch held the startup lock for over" << timeoutMs << "ms";
+        return false;
+    }
+    return true;
+}
+
+void SingleInstance::unlockStartup()
+{
+    if (s_startupLock) {
+        s_startupLock->unlock();
+    }
+}
+
+bool SingleInstance::forward(const QStringList &arguments, int timeoutMs)
+{
+    QLocalSocket socket;
+    socket.connectToServer(serverName());
+    if (!socket.waitForConnected(timeoutMs)) {
+        return false;
+    }
+
+    QByteArray message;
+    QDataStream stream(&message, QIODevice::WriteOnly);
+    stream << arguments;
+    socket.write(message);
+    if (!socket.waitForBytesWritten(timeoutMs) || !socket.waitForReadyRead(timeoutMs)) {
+        return false;
+    }
+    return socket.read(1) == QByteArray(1, Acknowledge);
+}
+
+bool SingleInstance::listen()
+{
+    const bool listening = listenOnce();
+    unlockStartup();
+    return listening;
+}
+
+bool SingleInstance::listenOnce()
+{
+    if (m_server->listen(serverName())) {
+        return true;
+    }
+
+    // Only a name nobody accepts connections on is left over from a crash;
+    // a live server means another instance got past a timed-out startup lock
+    QLocalSocket probe;
+    probe.connectToServer(serverName());
+    if (probe.waitForConnected(ProbeTimeoutMs)) {
+        qCWarning(lcStartup) << "Single instance: another instance is already listening on" << serverName();
+        return false;
+    }
+
+    QLocalServer::removeServer(serverName());
+    if (!m_server->listen(serverName())) {
+        qCWarning(lcStartup) << "Single instance: cannot listen on" << serverName() << "-" << m_server->errorString();
+        return false;
+    }
+    return true;
+}
+
+void SingleInstance::onNewConnection()
+{
+    while (QLocalSocket *socket = m_server->nextPendingConnection()) {
+        connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]() {
+            QDataStream stream(socket);
+            stream.startTransaction();
+            QStringList arguments;
+            stream >> arguments;
+            if (!stream.commitTransaction()) {
+                return;
+            }
+            socket->write(&Acknowledge, 1);
+            socket->flush();
+            qCDebug(lcStartup) << "Single instance: received" << arguments;
+            emit argumentsReceived(arguments);
+        });
+    }
+}
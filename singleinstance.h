@@ -0,0 +1,55 @@
+#ifndef SINGLEINSTANCE_H
+#define SINGLEINSTANCE_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+class QLocalServer;
+class QLockFile;
+
+// Single-instance mode. The first process listens on a local socket; later
+// launches hand their arguments to it with forward() and exit without
+// building any UI, while the running instance acts on them.
+class SingleInstance : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SingleInstance(QObject *parent = nullptr);
+
+    // Per user, so two users on one machine each get their own instance:
+    // a socket in the user's runtime directory, a named pipe on Windows
+    static QString serverName();
+
+    // Serializes startups: taken before forward() and held until listen()
+    // has finished, so a launch during another instance's cold start waits
+    // and then forwards to it instead of becoming a second instance. Gives
+    // up after timeoutMs (a lock left by a crashed process is taken over).
+    static bool lockStartup(int timeoutMs = 10000);
+    static void unlockStartup();
+
+    // Sends arguments to the running instance and waits for it to accept
+    // them; false when no instance is running. Only needs a QCoreApplication.
+    static bool forward(const QStringList &arguments, int timeoutMs = 1000);
+
+    // Starts accepting forwarded launches and releases the startup lock.
+    // A server name left behind by a crashed instance is removed first; one
+    // that still accepts connections belongs to a live instance and is kept.
+    bool listen();
+
+signals:
+    void argumentsReceived(const QStringList &arguments);
+
+private:
+    // QStandardPaths::RuntimeLocation, or the temp directory without one
+    static QString runtimeDirectory();
+    bool listenOnce();
+    void onNewConnection();
+
+    QLocalServer *m_server;
+
+    static QLockFile *s_startupLock;
+};
+
+#endif // SINGLEINSTANCE_H
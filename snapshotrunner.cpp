@@ -0,0 +1,209 @@
+#include "snapshotrunner.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QSet>
+#include <QTabWidget>
+#include <QTextStream>
+#include <QThreadPool>
+#include <QVector>
+
+#include <utility>
+
+#include "mainwindow.h"
+#include "imagediff.h"
+#include "logcategories.h"
+
+namespace {
+
+struct Comparison
+{
+    // Paths are built on the GUI thread, the jobs only read them
+    QString outputPath;
+    QString goldenPath;
+    QString diffPath;
+
+    bool written = false;
+    bool hasGolden = false;
+    ImageDiffResult diff;
+};
+
+void compareSnapshot(const QImage &image, int tolerance, Comparison &comparison)
+{
+    comparison.written = image.save(comparison.outputPath, "PNG");
+    QFile::remove(comparison.diffPath);
+    if (comparison.goldenPath.isEmpty()) {
+        return;
+    }
+
+    QImage golden;
+    comparison.hasGolden = golden.load(comparison.goldenPath, "PNG");
+    if (!comparison.hasGolden) {
+        return;
+    }
+
+    QImage diffImage;
+    comparison.diff = ImageDiff::compare(image, golden, tolerance, &diffImage);
+    if (!diffImage.isNull()) {
+        diffImage.save(comparison.diffPath, "PNG");
+    }
+}
+
+} // namespace
+
+SnapshotRunner::SnapshotRunner(MainWindow *window) : m_window(window)
+{
+}
+
+int SnapshotRunner::run(const SnapshotOptions &options)
+{
+    const QDir output(options.outputDirectory);
+    if (!QDir().mkpath(output.absolutePath())) {
+        qCWarning(lcUi) << "Cannot create snapshot directory:" << output.absolutePath();
+        return 1;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    m_snapshots.clear();
+    captureTabs();
+    captureDialogs();
+    const qint64 captureMs = timer.restart();
+
+    QVector<Comparison> comparisons(m_snapshots.size());
+    Comparison *results = comparisons.data();
+    const QDir golden(options.goldenDirectory);
+    for (int i = 0; i < m_snapshots.size(); ++i) {
+        const QString &name = m_snapshots.at(i).name;
+        results[i].outputPath = output.filePath(name + ".png");
+        results[i].diffPath = output.filePath(name + ".diff.png");
+        if (!options.goldenDirectory.isEmpty()) {
+            results[i].goldenPath = golden.filePath(name + ".png");
+        }
+    }
+
+    QThreadPool pool;
+    for (int i = 0; i < m_snapshots.size(); ++i) {
+        const QImage image = m_snapshots.at(i).image;
+        const int tolerance = options.tolerance;
+        pool.start([image, tolerance, results, i]() {
+            compareSnapshot(image, tolerance, results[i]);
+        });
+    }
+    pool.waitForDone();
+    const qint64 compareMs = timer.elapsed();
+
+    QTextStream out(stdout);
+    int failures = 0;
+    for (int i = 0; i < m_snapshots.size(); ++i) {
+        const Comparison &result = comparisons.at(i);
+        QString problem;
+        if (!result.written) {
+            problem = "cannot write " + result.outputPath;
+        } else if (options.goldenDirectory.isEmpty()) {
+            continue;
+        } else if (!result.hasGolden) {
+            problem = "no golden image";
+        } else if (!result.diff.sizeMatches) {
+            problem = "size differs from golden image";
+        } else if (result.diff.differingPixels > 0) {
+            problem = QString("%1 pixels differ, max delta %2").arg(result.diff.differingPixels).arg(result.diff.maxDelta);
+        } else {
+            continue;
+        }
+        ++failures;
+        out << "FAIL " << m_snapshots.at(i).name << ": " << problem << "\n";
+    }
+
+    out << m_snapshots.size() << " snapshots in " << output.absolutePath() << ": captured in " << captureMs
+        << " ms, written and compared in " << compareMs << " ms on " << pool.maxThreadCount() << " threads";
+    if (!options.goldenDirectory.isEmpty()) {
+        out << ", " << failures << " failed (tolerance " << options.tolerance << ")";
+    }
+    out << "\n";
+    return failures;
+}
+
+void SnapshotRunner::capture(const QString &name, QWidget *widget)
+{
+    // Deliver pending polish and layout requests so the grab matches a paint
+    QCoreApplication::sendPostedEvents();
+    m_snapshots.append({ name, widget->grab().toImage() });
+}
+
+void SnapshotRunner::captureTabs()
+{
+    QTabWidget *tabWidget = m_window->tabWidget();
+    if (!tabWidget) {
+        capture("window", m_window);
+        return;
+    }
+
+    const int current = tabWidget->currentIndex();
+    for (int i = 0; i < tabWidget->count(); ++i) {
+        // Selecting a tab builds it if it is not yet
+        tabWidget->setCurrentIndex(i);
+        QWidget *page = tabWidget->widget(i);
+        capture("tab-" + (page->objectName().isEmpty() ? QString::number(i) : page->objectName()), m_window);
+        captureButtons(page);
+    }
+    tabWidget->setCurrentIndex(current);
+}
+
+void SnapshotRunner::captureButtons(QWidget *page)
+{
+    const QList<QPushButton *> buttons = page->findChildren<QPushButton *>();
+    for (QPushButton *button : buttons) {
+        if (!button->isVisibleTo(page) || button->objectName().isEmpty()) {
+            continue;
+        }
+        const QString name = "button-" + button->objectName();
+
+        capture(name + "-normal", button);
+
+        // Style sheets and styles take :hover from the under-mouse attribute
+        button->setAttribute(Qt::WA_UnderMouse, true);
+        capture(name + "-hover", button);
+        button->setAttribute(Qt::WA_UnderMouse, false);
+
+        button->setDown(true);
+        capture(name + "-pressed", button);
+        button->setDown(false);
+
+        const bool enabled = button->isEnabled();
+        button->setEnabled(false);
+        capture(name + "-disabled", button);
+        button->setEnabled(enabled);
+    }
+}
+
+void SnapshotRunner::captureDialogs()
+{
+    // One snapshot per pooled dialog, i.e. per object name and style variant
+    QSet<QString> seen;
+    for (const ActionDefinition &action : m_window->actions().actions()) {
+        QList<DialogRequest> requests;
+        if (action.hasConfirmation) {
+            requests.append(action.confirmation);
+        }
+        requests.append(action.completion);
+
+        for (const DialogRequest &request : std::as_const(requests)) {
+            if (request.text.isEmpty() || seen.contains(request.objectName)) {
+                continue;
+            }
+            seen.insert(request.objectName);
+
+            // QMessageBox only sizes itself in showEvent()
+            QMessageBox *dialog = m_window->dialogs()->prepare(request);
+            dialog->show();
+            capture("dialog-" + (request.objectName.isEmpty() ? QStringLiteral("default") : request.objectName), dialog);
+            dialog->hide();
+        }
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef SNAPSHOTRUNNER_H
+#define SNAPSHOTRUNNER_H
+
+#include <QImage>
+#include <QList>
+#include <QString>
+
+class MainWindow;
+class QWidget;
+
+struct SnapshotOptions
+{
+    // Receives <name>.png for every snapshot and <name>.diff.png for each mismatch
+    QString outputDirectory;
+    // Golden <name>.png files; when empty the snapshots are only written
+    QString goldenDirectory;
+    // Per-channel difference (0-255) still treated as equal
+    int tolerance = 0;
+};
+
+// Headless visual check for --snapshot=<dir>. Grabs every tab, every button
+// in its normal, hover, pressed and disabled state, and every dialog variant
+// of the action table, then writes and compares them against golden images.
+// Grabbing has to happen on the GUI thread; PNG encoding and decoding and
+// the diffs, where the time goes, run on a thread pool.
+class SnapshotRunner
+{
+public:
+    explicit SnapshotRunner(MainWindow *window);
+
+    // Returns the number of snapshots that differ from their golden image,
+    // have none or could not be written
+    int run(const SnapshotOptions &options);
+
+private:
+    struct Snapshot
+    {
+        QString name;
+        QImage image;
+    };
+
+    void captureTabs();
+    void captureButtons(QWidget *page);
+    void captureDialogs();
+    void capture(const QString &name, QWidget *widget);
+
+    MainWindow *m_window;
+    QList<Snapshot> m_snapshots;
+};
+
+#endif // SNAPSHOTRUNNER_H
@@ -0,0 +1,266 @@
+#include "stallwatchdog.h"
+
+#include <QApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QDialog>
+#include <QDir>
+#include <QEvent>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMetaEnum>
+#include <QMutexLocker>
+
+#include <chrono>
+
+#include "logcategories.h"
+
+#if defined(Q_OS_LINUX) && defined(__GLIBC__)
+#define STALLWATCHDOG_HAS_BACKTRACE
+#include <csignal>
+#include <cstdlib>
+#include <execinfo.h>
+#include <pthread.h>
+#endif
+
+namespace {
+
+const int MinHeartbeatMs = 10;
+
+qint64 nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#ifdef STALLWATCHDOG_HAS_BACKTRACE
+
+// The watchdog thread signals the GUI thread, which records its own stack
+constexpr int MaxFrames = 64;
+void *s_frames[MaxFrames];
+std::atomic<int> s_frameCount{-1};
+pthread_t s_guiThread;
+
+int backtraceSignal()
+{
+    return SIGRTMIN + 3;
+}
+
+void backtraceHandler(int)
+{
+    s_frameCount.store(backtrace(s_frames, MaxFrames), std::memory_order_release);
+}
+
+void installBacktraceHandler()
+{
+    s_guiThread = pthread_self();
+
+    // The first backtrace() call loads libgcc; do it here, not in the handler
+    void *frame;
+    backtrace(&frame, 1);
+
+    struct sigaction action = {};
+    action.sa_handler = backtraceHandler;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(backtraceSignal(), &action, nullptr);
+}
+
+QStringList captureGuiBacktrace()
+{
+    QStringList frames;
+    s_frameCount.store(-1, std::memory_order_release);
+    if (pthread_kill(s_guiThread, backtraceSignal()) != 0) {
+        return frames;
+    }
+
+    for (int i = 0; i < 100 && s_frameCount.load(std::memory_order_acquire) < 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const int count = s_frameCount.load(std::memory_order_acquire);
+    if (count <= 0) {
+        return frames;
+    }
+
+    char **symbols = backtrace_symbols(s_frames, count);
+    if (!symbols) {
+        return frames;
+    }
+    // Frame 0 is the signal handler and frame 1 the kernel's signal trampoline
+    for (int i = 2; i < count; ++i) {
+        frames.append(QString::fromLocal8Bit(symbols[i]));
+    }
+    std::free(symbols);
+    return frames;
+}
+
+#endif
+
+} // namespace
+
+StallWatchdog::StallWatchdog(QObject *parent) : QObject(parent)
+{
+    m_heartbeat.setTimerType(Qt::PreciseTimer);
+    connect(&m_heartbeat, &QTimer::timeout, this, &StallWatchdog::beat);
+}
+
+StallWatchdog::~StallWatchdog()
+{
+    stop();
+}
+
+void StallWatchdog::start(const QString &reportPath, int thresholdMs)
+{
+    if (m_thread.joinable() || thresholdMs <= 0) {
+        return;
+    }
+
+    m_reportPath = reportPath;
+    m_thresholdNs = qint64(thresholdMs) * 1000000;
+    m_stopping = false;
+
+#ifdef STALLWATCHDOG_HAS_BACKTRACE
+    installBacktraceHandler();
+#endif
+
+    qApp->installEventFilter(this);
+    beat();
+    m_heartbeat.start(qMax(MinHeartbeatMs, thresholdMs / 4));
+    m_thread = std::thread(&StallWatchdog::watch, this);
+
+    qCDebug(lcWatchdog) << "Watching for GUI stalls over" << thresholdMs << "ms, reporting to" << reportPath;
+}
+
+void StallWatchdog::stop()
+{
+    if (!m_thread.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_stopMutex);
+        m_stopping = true;
+    }
+    m_stopCondition.notify_all();
+    m_thread.join();
+
+    m_heartbeat.stop();
+    if (qApp) {
+        qApp->removeEventFilter(this);
+    }
+}
+
+bool StallWatchdog::eventFilter(QObject *watched, QEvent *event)
+{
+    // An uncontended lock and a shared-string copy per event; the class name
+    // is static meta-object data, and formatting waits until a stall is seen
+    {
+        QMutexLocker locker(&m_receiverMutex);
+        m_receiverClass = watched->metaObject()->className();
+        m_receiverName = watched->objectName();
+        m_eventType = event->type();
+    }
+
+    if (event->type() == QEvent::Show || event->type() == QEvent::Hide) {
+        if (QDialog *dialog = qobject_cast<QDialog*>(watched)) {
+            QMutexLocker locker(&m_dialogMutex);
+            if (event->type() == QEvent::Show) {
+                m_dialog = dialog->objectName();
+            } else if (m_dialog == dialog->objectName()) {
+                m_dialog.clear();
+            }
+        }
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+void StallWatchdog::beat()
+{
+    m_lastBeatNs.store(nowNs(), std::memory_order_release);
+}
+
+void StallWatchdog::watch()
+{
+    const auto interval = std::chrono::nanoseconds(m_thresholdNs / 4);
+    bool stalled = false;
+    Stall stall;
+
+    std::unique_lock<std::mutex> lock(m_stopMutex);
+    while (!m_stopCondition.wait_for(lock, interval, [this]() { return m_stopping; })) {
+        const qint64 lastBeat = m_lastBeatNs.load(std::memory_order_acquire);
+        if (!stalled && nowNs() - lastBeat > m_thresholdNs) {
+            stalled = true;
+            stall = captureStall(lastBeat);
+        } else if (stalled && lastBeat != stall.startedNs) {
+            // The heartbeat is back; the stall lasted until this beat
+            stalled = false;
+            writeReport(stall, lastBeat - stall.startedNs);
+        }
+    }
+
+    if (stalled) {
+        writeReport(stall, nowNs() - stall.startedNs);
+    }
+}
+
+StallWatchdog::Stall StallWatchdog::captureStall(qint64 startedNs)
+{
+    Stall stall;
+    stall.startedNs = startedNs;
+
+    // Copies made by the GUI thread; the receiver itself may be deleted
+    int eventType = 0;
+    {
+        QMutexLocker locker(&m_receiverMutex);
+        if (m_receiverClass) {
+            stall.receiver = QString("%1 \"%2\"").arg(QString::fromLatin1(m_receiverClass), m_receiverName);
+        }
+        eventType = m_eventType;
+    }
+    const char *eventName = QMetaEnum::fromType<QEvent::Type>().valueToKey(eventType);
+    stall.eventType = eventName ? QString::fromLatin1(eventName) : QString::number(eventType);
+
+    {
+        QMutexLocker locker(&m_dialogMutex);
+        stall.dialog = m_dialog;
+    }
+
+#ifdef STALLWATCHDOG_HAS_BACKTRACE
+    stall.backtrace = captureGuiBacktrace();
+#endif
+    return stall;
+}
+
+void StallWatchdog::writeReport(const Stall &stall, qint64 durationNs)
+{
+    m_stallCount.fetch_add(1, std::memory_order_relaxed);
+
+    const qint64 ageMs = (nowNs() - stall.startedNs) / 1000000;
+    const double durationMs = durationNs / 1e6;
+
+    QJsonObject record;
+    record.insert("time", QDateTime::currentDateTimeUtc().addMSecs(-ageMs).toString(Qt::ISODateWithMs));
+    record.insert("durationMs", durationMs);
+    record.insert("receiver", stall.receiver);
+    record.insert("event", stall.eventType);
+    if (!stall.dialog.isEmpty()) {
+        record.insert("dialog", stall.dialog);
+    }
+    record.insert("backtrace", QJsonArray::fromStringList(stall.backtrace));
+
+    qCWarning(lcWatchdog) << "GUI thread stalled for" << durationMs << "ms in" << stall.receiver
+                          << stall.eventType;
+
+    // Created on the first stall rather than at startup
+    QDir().mkpath(QFileInfo(m_reportPath).absolutePath());
+    QFile file(m_reportPath);
+    if (!file.open(QFile::WriteOnly | QFile::Append)) {
+        qCWarning(lcWatchdog) << "Could not write stall report to:" << m_reportPath << "-" << file.errorString();
+        return;
+    }
+    file.write(QJsonDocument(record).toJson(QJsonDocument::Compact));
+    file.write("\n");
+}
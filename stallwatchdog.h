@@ -0,0 +1,82 @@
+#ifndef STALLWATCHDOG_H
+#define STALLWATCHDOG_H
+
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Detects GUI thread stalls. A timer on the GUI thread records a heartbeat;
+// a watchdog thread notices when the heartbeat is older than the threshold
+// and captures what the GUI thread was doing: the receiver of the event being
+// delivered, the dialog that is open, and a backtrace of the GUI thread
+// (Linux/glibc only). Each stall is appended to the report file as one JSON
+// line once the GUI thread responds again. Nested event loops (exec()) keep
+// the heartbeat going and so are not stalls.
+//
+// The receiver is described by data copied on the GUI thread as each event
+// is filtered (its class and object name); the watchdog thread never touches
+// the object, which may be gone by the time the stall is noticed. The slot
+// being run is not recorded separately: a queued slot arrives as a MetaCall
+// event whose target is only exposed by Qt's private QMetaCallEvent, and a
+// directly connected one runs inside another event's handler. In both cases
+// the slot is in the backtrace, and for MetaCall the receiver is its object.
+class StallWatchdog : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StallWatchdog(QObject *parent = nullptr);
+    ~StallWatchdog() override;
+
+    // Must be called on the GUI thread
+    void start(const QString &reportPath, int thresholdMs);
+    void stop();
+
+    int stallCount() const { return m_stallCount.load(std::memory_order_relaxed); }
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    struct Stall
+    {
+        qint64 startedNs = 0;
+        QString receiver;
+        QString eventType;
+        QString dialog;
+        QStringList backtrace;
+    };
+
+    void beat();
+    void watch();
+    Stall captureStall(qint64 startedNs);
+    void writeReport(const Stall &stall, qint64 durationNs);
+
+    QString m_reportPath;
+    qint64 m_thresholdNs = 0;
+    QTimer m_heartbeat;
+
+    // Written by the GUI thread, read by the watchdog thread
+    std::atomic<qint64> m_lastBeatNs{0};
+    QMutex m_receiverMutex;
+    const char *m_receiverClass = nullptr;
+    QString m_receiverName;
+    int m_eventType = 0;
+    QMutex m_dialogMutex;
+    QString m_dialog;
+
+    std::thread m_thread;
+    std::mutex m_stopMutex;
+    std::condition_variable m_stopCondition;
+    bool m_stopping = false;
+    std::atomic<int> m_stallCount{0};
+};
+
+#endif // STALLWATCHDOG_H
@@ -0,0 +1,174 @@
+#include "startuptracer.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QEvent>
+#include <QFile>
+#include <QTimer>
+#include <QVarLengthArray>
+#include <QWidget>
+
+#include <cstring>
+
+#include "logcategories.h"
+#include "metrics.h"
+
+bool StartupTracer::s_enabled = false;
+QString StartupTracer::s_outputPath;
+QElapsedTimer StartupTracer::s_clock;
+StartupTracer::Event StartupTracer::s_events[StartupTracer::MaxEvents];
+int StartupTracer::s_eventCount = 0;
+
+namespace {
+
+const char TraceFlag[] = "--trace-startup=";
+
+// Closes the "first paint" phase after the first paint event has been delivered
+class FirstPaintWatcher : public QObject
+{
+public:
+    explicit FirstPaintWatcher(QWidget *window) : QObject(window) {}
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override
+    {
+        if (event->type() == QEvent::Paint && !m_seen) {
+            m_seen = true;
+            StartupTracer::begin("first paint");
+            // Paint events for the whole window are flushed in one pass, so the
+            // frame is done once control returns to the event loop
+            QTimer::singleShot(0, this, [this]() {
+                StartupTracer::end("first paint");
+                StartupTracer::publishMetrics();
+                StartupTracer::writeTrace();
+                deleteLater();
+            });
+        }
+        return QObject::eventFilter(watched, event);
+    }
+
+private:
+    bool m_seen = false;
+};
+
+} // namespace
+
+void StartupTracer::enableFromArguments(int argc, char *argv[])
+{
+    const size_t flagLength = std::strlen(TraceFlag);
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], TraceFlag, flagLength) == 0 && argv[i][flagLength] != '\0') {
+            s_outputPath = QString::fromLocal8Bit(argv[i] + flagLength);
+            s_eventCount = 0;
+            s_clock.start();
+            s_enabled = true;
+            return;
+        }
+    }
+}
+
+void StartupTracer::enableRecording()
+{
+    if (s_enabled)
+        return;
+
+    s_eventCount = 0;
+    s_clock.start();
+    s_enabled = true;
+}
+
+void StartupTracer::record(const char *name, char phase, int arg)
+{
+    if (s_eventCount >= MaxEvents)
+        return;
+
+    Event &event = s_events[s_eventCount++];
+    event.name = name;
+    event.phase = phase;
+    event.arg = arg;
+    event.timestampNs = s_clock.nsecsElapsed();
+}
+
+void StartupTracer::finishOnFirstPaint(QWidget *window)
+{
+    if (!s_enabled || !window)
+        return;
+
+    window->installEventFilter(new FirstPaintWatcher(window));
+}
+
+void StartupTracer::publishMetrics()
+{
+    if (!s_enabled)
+        return;
+
+    // Phases nest, so each end closes the latest open begin of the same name
+    QVarLengthArray<int, 32> open;
+    for (int i = 0; i < s_eventCount; ++i) {
+        const Event &event = s_events[i];
+        if (event.phase == 'B') {
+            open.append(i);
+            continue;
+        }
+        for (int j = open.size() - 1; j >= 0; --j) {
+            const Event &begin = s_events[open.at(j)];
+            if (std::strcmp(begin.name, event.name) != 0 || begin.arg != event.arg)
+                continue;
+
+            MetricsRegistry::Labels labels = { { "phase", QString::fromLatin1(event.name) } };
+            if (event.arg >= 0)
+                labels.append({ "index", QString::number(event.arg) });
+            MetricsRegistry::gauge("qttwobuttons_startup_phase_seconds", "Duration of each startup phase", labels)
+                ->set((event.timestampNs - begin.timestampNs) / 1e9);
+            open.remove(j);
+            break;
+        }
+    }
+
+    MetricsRegistry::gauge("qttwobuttons_startup_seconds", "Time from process start to the end of the first paint")
+        ->set(s_clock.nsecsElapsed() / 1e9);
+}
+
+bool StartupTracer::writeTrace()
+{
+    if (!s_enabled)
+        return false;
+
+    s_enabled = false;
+    if (s_outputPath.isEmpty())
+        return false;
+
+    const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+
+    QByteArray json;
+    json.reserve(s_eventCount * 96 + 64);
+    json += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    for (int i = 0; i < s_eventCount; ++i) {
+        const Event &event = s_events[i];
+        json += "{\"name\":\"";
+        json += event.name;
+        json += "\",\"cat\":\"startup\",\"ph\":\"";
+        json += event.phase;
+        json += "\",\"ts\":";
+        json += QByteArray::number(event.timestampNs / 1000.0, 'f', 3);
+        json += ",\"pid\":";
+        json += pid;
+        json += ",\"tid\":1";
+        if (event.arg >= 0) {
+            json += ",\"args\":{\"index\":";
+            json += QByteArray::number(event.arg);
+            json += "}";
+        }
+        json += (i + 1 < s_eventCount) ? "},\n" : "}\n";
+    }
+    json += "]}\n";
+
+    QFile file(s_outputPath);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+        qCWarning(lcStartup) << "Could not write startup trace to:" << s_outputPath << "-" << file.errorString();
+        return false;
+    }
+    file.write(json);
+    qCDebug(lcStartup) << "Startup trace written to:" << s_outputPath << "(" << s_eventCount << "events )";
+    return true;
+}
@@ -0,0 +1,78 @@
+#ifndef STARTUPTRACER_H
+#define STARTUPTRACER_H
+
+#include <QElapsedTimer>
+#include <QString>
+
+class QWidget;
+
+// Records monotonic timestamps for startup phases into a fixed buffer and
+// writes them as Chrome trace-event JSON (loadable in Perfetto / chrome://tracing).
+// Enabled with --trace-startup=<file>, or by enableRecording() for the metrics
+// only; when disabled every call is a single branch.
+class StartupTracer
+{
+public:
+    // Looks for --trace-startup=<file> in the raw arguments. Must run before
+    // QApplication is constructed so that phase can be traced too.
+    static void enableFromArguments(int argc, char *argv[]);
+
+    // Records without writing a trace file; the phase durations still go to
+    // qttwobuttons_startup_phase_seconds on the first paint
+    static void enableRecording();
+
+    static bool isEnabled() { return s_enabled; }
+
+    // name must point to a string literal; arg is emitted as args.index when >= 0
+    static void begin(const char *name, int arg = -1) { if (s_enabled) record(name, 'B', arg); }
+    static void end(const char *name, int arg = -1) { if (s_enabled) record(name, 'E', arg); }
+
+    // Records the first paint of window; once it is done, publishes the phase
+    // durations as metrics and writes the trace file
+    static void finishOnFirstPaint(QWidget *window);
+
+    static void publishMetrics();
+    static bool writeTrace();
+
+private:
+    struct Event
+    {
+        const char *name;
+        char phase;
+        int arg;
+        qint64 timestampNs;
+    };
+
+    static constexpr int MaxEvents = 256;
+
+    static void record(const char *name, char phase, int arg);
+
+    static bool s_enabled;
+    static QString s_outputPath;
+    static QElapsedTimer s_clock;
+    static Event s_events[MaxEvents];
+    static int s_eventCount;
+};
+
+// Traces the enclosing scope as one phase
+class StartupTraceScope
+{
+public:
+    explicit StartupTraceScope(const char *name, int arg = -1) : m_name(name), m_arg(arg)
+    {
+        StartupTracer::begin(m_name, m_arg);
+    }
+    ~StartupTraceScope()
+    {
+        StartupTracer::end(m_name, m_arg);
+    }
+
+    StartupTraceScope(const StartupTraceScope &) = delete;
+    StartupTraceScope &operator=(const StartupTraceScope &) = delete;
+
+private:
+    const char *m_name;
+    int m_arg;
+};
+
+#endif // STARTUPTRACER_H
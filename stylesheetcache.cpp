@@ -0,0 +1,230 @@
+#include "stylesheetcache.h"
+
+#include <QCryptographicHash>
+#include <QVariant>
+#include <QWidget>
+
+const QString StyleSheetCache::UnscopedName;
+QHash<QByteArray, StyleSheetCache::Entry> StyleSheetCache::s_cache;
+int StyleSheetCache::s_hits = 0;
+int StyleSheetCache::s_misses = 0;
+
+namespace {
+
+const QLatin1String ScopeMarker("@scope ");
+
+} // namespace
+
+StyleSheetCache::ScopedSheets StyleSheetCache::split(const QString &styleSheet)
+{
+    // Hashed as UTF-16 in place, without converting the sheet
+    const QByteArray digest = QCryptographicHash::hash(
+        QByteArray::fromRawData(reinterpret_cast<const char *>(styleSheet.utf16()),
+                                styleSheet.size() * qsizetype(sizeof(char16_t))),
+        QCryptographicHash::Sha256);
+
+    auto it = s_cache.constFind(digest);
+    if (it != s_cache.constEnd() && it->source == styleSheet) {
+        ++s_hits;
+        return it->sheets;
+    }
+
+    ++s_misses;
+    const ScopedSheets sheets = tokenize(styleSheet);
+    s_cache.insert(digest, { styleSheet, sheets });
+    return sheets;
+}
+
+void StyleSheetCache::clear()
+{
+    s_cache.clear();
+    s_hits = 0;
+    s_misses = 0;
+}
+
+StyleSheetCache::ScopedSheets StyleSheetCache::tokenize(const QString &styleSheet)
+{
+    ScopedSheets sheets;
+    QString scope = UnscopedName;
+    QString current;
+    current.reserve(styleSheet.size());
+
+    auto flush = [&]() {
+        const QString trimmed = current.trimmed();
+        if (!trimmed.isEmpty()) {
+            QString &sheet = sheets[scope];
+            if (!sheet.isEmpty()) {
+                sheet += QLatin1Char(' ');
+            }
+            sheet += trimmed;
+        }
+        current.clear();
+    };
+
+    const int length = styleSheet.size();
+    QChar quote;
+    bool pendingSpace = false;
+    for (int i = 0; i < length; ++i) {
+        const QChar c = styleSheet.at(i);
+
+        // Quoted strings are copied verbatim
+        if (!quote.isNull()) {
+            current += c;
+            if (c == quote) {
+                quote = QChar();
+            }
+            continue;
+        }
+
+        if (c == QLatin1Char('/') && i + 1 < length && styleSheet.at(i + 1) == QLatin1Char('*')) {
+            int end = styleSheet.indexOf(QLatin1String("*/"), i + 2);
+            if (end < 0) {
+                end = length;
+            }
+            const QString comment = styleSheet.mid(i + 2, end - i - 2).trimmed();
+            if (comment.startsWith(ScopeMarker)) {
+                flush();
+                scope = comment.mid(ScopeMarker.size()).trimmed();
+                pendingSpace = false;
+            }
+            i = end + 1;
+            continue;
+        }
+
+        if (c.isSpace()) {
+            pendingSpace = !current.isEmpty();
+            continue;
+        }
+
+        if (pendingSpace) {
+            current += QLatin1Char(' ');
+            pendingSpace = false;
+        }
+        if (c == QLatin1Char('"') || c == QLatin1Char('\'')) {
+            quote = c;
+        }
+        current += c;
+    }
+    flush();
+
+    return sheets;
+}
+
+QHash<QString, QString> StyleSheetCache::rulesBySelector(const QString &sheet)
+{
+    // sheet is already normalized by tokenize(): no comments, single spaces
+    QHash<QString, QString> rules;
+    int start = 0;
+    while (start < sheet.size()) {
+        const int open = sheet.indexOf(QLatin1Char('{'), start);
+        const int close = open < 0 ? -1 : sheet.indexOf(QLatin1Char('}'), open);
+        if (close < 0) {
+            break;
+        }
+        const QString body = sheet.mid(open + 1, close - open - 1).trimmed();
+        const QStringList selectors = sheet.mid(start, open - start).split(QLatin1Char(','));
+        for (const QString &selector : selectors) {
+            QString &declarations = rules[selector.trimmed()];
+            // Later rules for the same selector add to the earlier ones
+            declarations += declarations.isEmpty() ? body : QLatin1Char(' ') + body;
+        }
+        start = close + 1;
+    }
+    return rules;
+}
+
+QStringList StyleSheetCache::changedSelectors(const QString &before, const QString &after)
+{
+    const QHash<QString, QString> oldRules = rulesBySelector(before);
+    const QHash<QString, QString> newRules = rulesBySelector(after);
+
+    QStringList changed;
+    for (auto it = newRules.cbegin(); it != newRules.cend(); ++it) {
+        if (oldRules.value(it.key()) != it.value()) {
+            changed.append(it.key());
+        }
+    }
+    for (auto it = oldRules.cbegin(); it != oldRules.cend(); ++it) {
+        if (!newRules.contains(it.key())) {
+            changed.append(it.key());
+        }
+    }
+    changed.sort();
+    return changed;
+}
+
+bool StyleSheetCache::selectorMatches(const QString &selector, const QWidget *widget)
+{
+    // Last compound selector, without pseudo states and sub-controls
+    QString compound = selector.section(QLatin1Char(' '), -1).section(QLatin1Char('>'), -1);
+    const int bracket = compound.lastIndexOf(QLatin1Char(']'));
+    const int pseudo = compound.indexOf(QLatin1Char(':'), bracket + 1);
+    if (pseudo >= 0) {
+        compound.truncate(pseudo);
+    }
+
+    int typeEnd = 0;
+    while (typeEnd < compound.size() && (compound.at(typeEnd).isLetterOrNumber()
+                                         || compound.at(typeEnd) == QLatin1Char('_')
+                                         || compound.at(typeEnd) == QLatin1Char('*')
+                                         || compound.at(typeEnd) == QLatin1Char('.'))) {
+        ++typeEnd;
+    }
+    QString type = compound.left(typeEnd);
+    if (type.startsWith(QLatin1Char('.'))) {
+        // ".QPushButton" matches that class only, not subclasses
+        if (QString::fromLatin1(widget->metaObject()->className()) != type.mid(1)) {
+            return false;
+        }
+    } else if (!type.isEmpty() && type != QLatin1String("*") && !widget->inherits(type.toLatin1().constData())) {
+        return false;
+    }
+
+    int pos = typeEnd;
+    while (pos < compound.size()) {
+        const QChar c = compound.at(pos);
+        if (c == QLatin1Char('#')) {
+            int end = pos + 1;
+            while (end < compound.size() && compound.at(end) != QLatin1Char('[')
+                   && compound.at(end) != QLatin1Char('#')) {
+                ++end;
+            }
+            if (widget->objectName() != compound.mid(pos + 1, end - pos - 1)) {
+                return false;
+            }
+            pos = end;
+        } else if (c == QLatin1Char('[')) {
+            const int end = compound.indexOf(QLatin1Char(']'), pos);
+            if (end < 0) {
+                return true;
+            }
+            const QString condition = compound.mid(pos + 1, end - pos - 1);
+            const int equals = condition.indexOf(QLatin1Char('='));
+            if (equals > 0 && !condition.at(equals - 1).isLetterOrNumber()) {
+                // ~= and friends: do not try to evaluate, assume it may match
+                pos = end + 1;
+                continue;
+            }
+            const QString name = condition.left(equals < 0 ? condition.size() : equals).trimmed();
+            const QVariant value = widget->property(name.toLatin1().constData());
+            if (equals < 0) {
+                if (!value.isValid()) {
+                    return false;
+                }
+            } else {
+                QString expected = condition.mid(equals + 1).trimmed();
+                if (expected.size() >= 2 && (expected.startsWith(QLatin1Char('"'))
+                                             || expected.startsWith(QLatin1Char('\'')))) {
+                    expected = expected.mid(1, expected.size() - 2);
+                }
+                if (value.toString() != expected) {
+                    return false;
+                }
+            }
+            pos = end + 1;
+        } else {
+            ++pos;
+        }
+    }
+    return true;
+}
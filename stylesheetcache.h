@@ -0,0 +1,54 @@
+#ifndef STYLESHEETCACHE_H
+#define STYLESHEETCACHE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+class QWidget;
+
+// Splits a stylesheet into per-subtree sheets at "/* @scope <name> */" markers,
+// stripping comments and collapsing whitespace on the way. Results are cached
+// in memory by the SHA-256 of the sheet content and checked against the full
+// text, so applying an unchanged sheet again does not tokenize it twice.
+class StyleSheetCache
+{
+public:
+    using ScopedSheets = QHash<QString, QString>;
+
+    // Content before the first marker, or a sheet without markers, ends up
+    // under UnscopedName
+    static const QString UnscopedName;
+
+    static ScopedSheets split(const QString &styleSheet);
+
+    // Selectors whose declarations differ between two sheets as returned by
+    // split() for the same scope, including added and removed rules
+    static QStringList changedSelectors(const QString &before, const QString &after);
+
+    // Whether selector can apply to widget, judged by its last compound
+    // selector (type, #id and [property="value"]); ancestors and pseudo
+    // states are ignored, so it may report a match that does not apply
+    static bool selectorMatches(const QString &selector, const QWidget *widget);
+
+    static int hits() { return s_hits; }
+    static int misses() { return s_misses; }
+    static void clear();
+
+private:
+    struct Entry
+    {
+        QString source;
+        ScopedSheets sheets;
+    };
+
+    static ScopedSheets tokenize(const QString &styleSheet);
+    static QHash<QString, QString> rulesBySelector(const QString &sheet);
+
+    static QHash<QByteArray, Entry> s_cache;
+    static int s_hits;
+    static int s_misses;
+};
+
+#endif // STYLESHEETCACHE_H